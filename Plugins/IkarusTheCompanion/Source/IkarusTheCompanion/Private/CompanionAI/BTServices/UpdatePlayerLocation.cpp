@@ -4,10 +4,13 @@
 #include "CompanionAI/BTServices/UpdatePlayerLocation.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
 #include "AIController.h"
 #include "Perception/AIPerceptionComponent.h"
 #include "Perception/AISense_Sight.h"
 #include "GameFramework/PlayerController.h"
+#include "NavigationSystem.h"
+#include "CompanionAI/CompanionControllers/AICompanionController.h"
 
 UUpdatePlayerLocation::UUpdatePlayerLocation()
 {
@@ -34,6 +37,18 @@ void UUpdatePlayerLocation::InitializeFromAsset(UBehaviorTree& Asset)
 	MoveThresholdSq = FMath::Square(MoveThreshold);
 }
 
+void UUpdatePlayerLocation::ScheduleNextTick(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	float IntervalScale = 1.f;
+	if (const AAICompanionController* Companion = Cast<AAICompanionController>(OwnerComp.GetAIOwner()))
+	{
+		IntervalScale = Companion->GetAILODSettings().ServiceIntervalScale;
+	}
+
+	const float NextTickTime = FMath::FRandRange(FMath::Max(0.f, Interval - RandomDeviation), Interval + RandomDeviation);
+	SetNextTickTime(NodeMemory, NextTickTime * IntervalScale);
+}
+
 void UUpdatePlayerLocation::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
 {
 		/* ---------- authority & replay gating ---------- */
@@ -50,17 +65,19 @@ void UUpdatePlayerLocation::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* N
 		return;
 	}
 
+	FUpdatePlayerLocationMemory* Memory = CastInstanceNodeMemory<FUpdatePlayerLocationMemory>(NodeMemory);
+
 	/* ---------- resolve / cache player actor ---------- */
 	AActor* Player = nullptr;
 
 	if (ActKeyId != FBlackboard::InvalidKey)
 	{
-		Player = Cast<AActor>(BB->GetValueAsObject(PlayerActorKey.SelectedKeyName));
+		Player = Cast<AActor>(BB->GetValue<UBlackboardKeyType_Object>(ActKeyId));
 	}
 
 	if (!Player || !Player->IsValidLowLevel())
 	{
-		Player = CachedPlayer.Get();
+		Player = Memory->CachedPlayer.Get();
 	}
 
 	if (!Player)
@@ -68,7 +85,7 @@ void UUpdatePlayerLocation::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* N
 		if (const APlayerController* PC = OwnerComp.GetWorld()->GetFirstPlayerController())
 		{
 			Player = PC->GetPawn();
-			CachedPlayer = Player;
+			Memory->CachedPlayer = Player;
 		}
 	}
 	if (!Player) return;
@@ -86,7 +103,15 @@ void UUpdatePlayerLocation::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* N
 	}
 
 	/* ---------- line-of-sight gate (optional but cheap) ---------- */
-	if (AAIController* Ctrl = Cast<AAIController>(OwnerComp.GetAIOwner()))
+	// Constant-time lookup into the companion's stimulus history, no perception info copy;
+	// records that already left the ring fall back to the perception component
+	const AAICompanionController* Companion = Cast<AAICompanionController>(OwnerComp.GetAIOwner());
+	const FCompanionStimulusRecord* Sight = Companion ? Companion->GetStimulusHistory().FindLatest(Player, UAISense::GetSenseID<UAISense_Sight>()) : nullptr;
+	if (Sight)
+	{
+		if (!Sight->bSensed) return;      // no LOS – let other tasks handle
+	}
+	else if (AAIController* Ctrl = OwnerComp.GetAIOwner())
 	{
 		if (UAIPerceptionComponent* Perc = Ctrl->GetPerceptionComponent())
 		{
@@ -108,10 +133,77 @@ void UUpdatePlayerLocation::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* N
 		}
 	}
 
+	/* ---------- predictive target ---------- */
+	if (bPredictTarget)
+	{
+		const FVector Predicted = PredictLocation(*Player, *Memory, OwnerComp.GetWorld()->GetTimeSeconds());
+
+		// Followers only repath when the prediction has drifted; the nav query runs just for writes.
+		// Compare unclipped predictions, or running at a wall would keep the prediction past the clipped point forever
+		if (FVector::DistSquared(Predicted, Memory->LastPredicted) < FMath::Square(PredictionErrorThreshold))
+		{
+			return;
+		}
+		Memory->LastPredicted = Predicted;
+
+		// Stop the lead at walls and ledges so the target stays reachable
+		FVector Target = Predicted;
+		FVector HitLocation;
+		if (UNavigationSystemV1::NavigationRaycast(OwnerComp.GetWorld(), NewLoc, Predicted, HitLocation, nullptr, OwnerComp.GetAIOwner()))
+		{
+			Target = HitLocation;
+		}
+
+		BB->SetValue<UBlackboardKeyType_Vector>(LocKeyId, Target);
+		Memory->LastWritten = Target;
+		return;
+	}
+
 	/* ---------- threshold gate & write ---------- */
-	if (FVector::DistSquared(NewLoc, LastWritten) >= MoveThresholdSq)
+	if (FVector::DistSquared(NewLoc, Memory->LastWritten) >= MoveThresholdSq)
 	{
-		BB->SetValueAsVector(PlayerLocationKey.SelectedKeyName, NewLoc);
-		LastWritten = NewLoc;
+		BB->SetValue<UBlackboardKeyType_Vector>(LocKeyId, NewLoc);
+		Memory->LastWritten = NewLoc;
 	}
 }
+
+FVector UUpdatePlayerLocation::PredictLocation(const AActor& Player, FUpdatePlayerLocationMemory& Memory, double Now) const
+{
+	const FVector Location = Player.GetActorLocation();
+	const FVector Velocity = Player.GetVelocity();
+
+	// Acceleration from the velocity change between service ticks, smoothed against input jitter
+	const double Elapsed = Now - Memory.LastSampleTime;
+	if (Memory.LastSampleTime >= 0.0 && Elapsed > UE_KINDA_SMALL_NUMBER)
+	{
+		const FVector Sampled = (Velocity - Memory.LastVelocity) / Elapsed;
+		Memory.Acceleration = FMath::Lerp(Memory.Acceleration, Sampled, 0.5f);
+	}
+	Memory.LastVelocity = Velocity;
+	Memory.LastSampleTime = Now;
+
+	// Stopping players should not be extrapolated past where they stop
+	FVector Offset = Velocity * PredictionHorizon + 0.5f * Memory.Acceleration * FMath::Square(PredictionHorizon);
+	if (FVector::DotProduct(Offset, Velocity) <= 0.f)
+	{
+		return Location;
+	}
+
+	Offset.Z = 0.f;
+	return Location + Offset.GetClampedToMaxSize(MaxPredictionDistance);
+}
+
+uint16 UUpdatePlayerLocation::GetInstanceMemorySize() const
+{
+	return sizeof(FUpdatePlayerLocationMemory);
+}
+
+void UUpdatePlayerLocation::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FUpdatePlayerLocationMemory>(NodeMemory, InitType);
+}
+
+void UUpdatePlayerLocation::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FUpdatePlayerLocationMemory>(NodeMemory, CleanupType);
+}
@@ -5,10 +5,11 @@
 #include "AIController.h"
 #include "NavigationSystem.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
 #include "GameFramework/Character.h"
 #include "Kismet/GameplayStatics.h"
 #include "DrawDebugHelpers.h"
-
+#include "CompanionAI/Subsystems/CompanionWorldSubsystem.h"
 
 UFindPlayerLocation::UFindPlayerLocation(FObjectInitializer const& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -23,13 +24,20 @@ UFindPlayerLocation::UFindPlayerLocation(FObjectInitializer const& ObjectInitial
 	MinDistanceFromPlayer = 100.0f;
 	UseDirectionalBias = false;
 	DirectionalPreference = EPositioningPreference::NoPreference;
+	UseFollowSlots = false;
+	UseBatchedSearch = true;
+	CandidateCount = 12;
+	DistanceWeight = 1.0f;
+	DirectionWeight = 1.0f;
+	NoveltyWeight = 0.5f;
 	AvoidPreviousLocations = false;
-	LocationMemorySize = 5;
 	DrawDebugPoints = false;
 	DebugDuration = 5.0f;
 	
 	// Configure blackboard key
 	BlackboardKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UFindPlayerLocation, BlackboardKey));
+	
+	bNotifyTaskFinished = true;
 }
 
 EBTNodeResult::Type UFindPlayerLocation::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
@@ -61,38 +69,58 @@ EBTNodeResult::Type UFindPlayerLocation::ExecuteTask(UBehaviorTreeComponent& Own
 	// Get player character
 	if (auto* const PlayerCharacter = UGameplayStatics::GetPlayerCharacter(World, 0))
 	{
-		FVector TargetPlayerLocation;
-		
 		if (UseExactLocation)
 		{
 			// Use exact player location
-			TargetPlayerLocation = PlayerCharacter->GetActorLocation();
-			
-			// Set value in blackboard
-			BlackboardComp->SetValueAsVector(BlackboardKey.SelectedKeyName, TargetPlayerLocation);
-			
-			if (DrawDebugPoints)
+			CommitLocation(OwnerComp, PlayerCharacter->GetActorLocation());
+			return EBTNodeResult::Succeeded;
+		}
+		
+		UCompanionWorldSubsystem* CompanionWorld = World->GetSubsystem<UCompanionWorldSubsystem>();
+		FFindPlayerLocationMemory* Memory = CastInstanceNodeMemory<FFindPlayerLocationMemory>(NodeMemory);
+		Memory->bUsedFollowSlot = false;
+		
+		// Followers of the same player share one ring of projected slots, as long as ours suits this node
+		FVector SlotLocation;
+		if (UseFollowSlots && CompanionWorld && CompanionWorld->ClaimFollowSlot(PlayerCharacter, AIController, SlotLocation))
+		{
+			if (IsFollowSlotUsable(PlayerCharacter, SlotLocation))
 			{
-				DrawDebugSphere(World, TargetPlayerLocation, 50.0f, 8, FColor::Green, false, DebugDuration);
+				Memory->bUsedFollowSlot = true;
+				RememberLocation(PlayerCharacter, SlotLocation);
+				CommitLocation(OwnerComp, SlotLocation);
+				return EBTNodeResult::Succeeded;
 			}
-			
-			return EBTNodeResult::Succeeded;
+			CompanionWorld->ReleaseFollowSlot(AIController);
 		}
-		else
+		
+		// The nearby search costs several nav queries plus traces: run it inside the companion work budget
+		if (CompanionWorld)
 		{
-			// Find a nearby location
-			if (FindNearbyLocation(PlayerCharacter, TargetPlayerLocation))
+			const TSharedRef<FFindPlayerLocationSearch> Search = MakeShared<FFindPlayerLocationSearch>();
+			Search->OwnerComp = &OwnerComp;
+			Search->Player = PlayerCharacter;
+			Memory->Search = Search;
+			
+			// Neither the node nor its memory is captured directly: both may be gone by the time the item runs
+			Memory->WorkHandle = CompanionWorld->SubmitWork(&OwnerComp, [WeakThis = TWeakObjectPtr<UFindPlayerLocation>(this), WeakSearch = Search.ToWeakPtr()]()
 			{
-				// Set value in blackboard
-				BlackboardComp->SetValueAsVector(BlackboardKey.SelectedKeyName, TargetPlayerLocation);
-				
-				if (DrawDebugPoints)
+				const TSharedPtr<FFindPlayerLocationSearch> Pinned = WeakSearch.Pin();
+				if (UFindPlayerLocation* This = WeakThis.Get(); This && Pinned)
 				{
-					DrawDebugSphere(World, TargetPlayerLocation, 50.0f, 8, FColor::Green, false, DebugDuration);
+					This->RunSearch(Pinned.ToSharedRef());
 				}
-				
-				return EBTNodeResult::Succeeded;
-			}
+			});
+			return EBTNodeResult::InProgress;
+		}
+		
+		// No subsystem (e.g. editor preview): search synchronously
+		TArray<FVector> Candidates;
+		FVector TargetPlayerLocation;
+		if (GatherCandidates(PlayerCharacter, Candidates) && PickCandidate(PlayerCharacter, Candidates, nullptr, TargetPlayerLocation))
+		{
+			CommitLocation(OwnerComp, TargetPlayerLocation);
+			return EBTNodeResult::Succeeded;
 		}
 	}
 	else
@@ -103,8 +131,76 @@ EBTNodeResult::Type UFindPlayerLocation::ExecuteTask(UBehaviorTreeComponent& Own
 	return EBTNodeResult::Failed;
 }
 
-bool UFindPlayerLocation::FindNearbyLocation(AActor* PlayerActor, FVector& OutLocation)
+EBTNodeResult::Type UFindPlayerLocation::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
+	// Drop a search that has not run yet (the handle of one that already ran is simply not found)
+	FFindPlayerLocationMemory* Memory = CastInstanceNodeMemory<FFindPlayerLocationMemory>(NodeMemory);
+	if (Memory->WorkHandle != 0)
+	{
+		if (UCompanionWorldSubsystem* CompanionWorld = OwnerComp.GetWorld() ? OwnerComp.GetWorld()->GetSubsystem<UCompanionWorldSubsystem>() : nullptr)
+		{
+			CompanionWorld->CancelWork(Memory->WorkHandle);
+		}
+		Memory->WorkHandle = 0;
+	}
+	
+	// Traces already in flight still report back, but can no longer reach the search
+	Memory->Search.Reset();
+	
+	return EBTNodeResult::Aborted;
+}
+
+void UFindPlayerLocation::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
+{
+	// A committed slot stays ours while we head there; anything else gives it back to the other followers
+	FFindPlayerLocationMemory* Memory = CastInstanceNodeMemory<FFindPlayerLocationMemory>(NodeMemory);
+	if (UseFollowSlots && !(Memory->bUsedFollowSlot && TaskResult == EBTNodeResult::Succeeded))
+	{
+		if (UCompanionWorldSubsystem* CompanionWorld = OwnerComp.GetWorld() ? OwnerComp.GetWorld()->GetSubsystem<UCompanionWorldSubsystem>() : nullptr)
+		{
+			CompanionWorld->ReleaseFollowSlot(OwnerComp.GetAIOwner());
+		}
+	}
+	Memory->bUsedFollowSlot = false;
+	Memory->WorkHandle = 0;
+	Memory->Search.Reset();
+	
+	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+}
+
+uint16 UFindPlayerLocation::GetInstanceMemorySize() const
+{
+	return sizeof(FFindPlayerLocationMemory);
+}
+
+void UFindPlayerLocation::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FFindPlayerLocationMemory>(NodeMemory, InitType);
+}
+
+void UFindPlayerLocation::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FFindPlayerLocationMemory>(NodeMemory, CleanupType);
+}
+
+void UFindPlayerLocation::CommitLocation(UBehaviorTreeComponent& OwnerComp, const FVector& Location) const
+{
+	// Set value in blackboard
+	if (UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent())
+	{
+		BlackboardComp->SetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID(), Location);
+	}
+	
+	if (DrawDebugPoints)
+	{
+		DrawDebugSphere(OwnerComp.GetWorld(), Location, 50.0f, 8, FColor::Green, false, DebugDuration);
+	}
+}
+
+bool UFindPlayerLocation::GatherCandidates(AActor* PlayerActor, TArray<FVector>& OutCandidates)
+{
+	OutCandidates.Reset();
+	
 	UWorld* World = GetWorld();
 	if (!World || !PlayerActor)
 	{
@@ -118,10 +214,32 @@ bool UFindPlayerLocation::FindNearbyLocation(AActor* PlayerActor, FVector& OutLo
 		return false;
 	}
 	
+	if (UseBatchedSearch)
+	{
+		GatherScoredCandidates(PlayerActor, *NavSys, OutCandidates);
+	}
+	else
+	{
+		GatherRandomCandidates(PlayerActor, *NavSys, OutCandidates);
+	}
+	
+	if (OutCandidates.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BTTask_FindPlayerLocation: No candidate location around the player"));
+		return false;
+	}
+	return true;
+}
+
+void UFindPlayerLocation::GatherRandomCandidates(AActor* PlayerActor, UNavigationSystemV1& NavSys, TArray<FVector>& OutCandidates) const
+{
+	UWorld* World = GetWorld();
 	const FVector PlayerLocation = PlayerActor->GetActorLocation();
+	const FCompanionVisitedGrid* Visited = FindVisitedGrid(PlayerActor);
+	const UCompanionWorldSubsystem* CompanionWorld = World->GetSubsystem<UCompanionWorldSubsystem>();
 	FNavLocation ResultLocation;
 	
-	// Try to find a valid location up to MaxAttempts times
+	// Up to MaxAttempts random points, in the order they were drawn
 	const int32 MaxAttempts = 10; // Default max attempts
 	
 	for (int32 Attempt = 0; Attempt < MaxAttempts; Attempt++)
@@ -136,7 +254,7 @@ bool UFindPlayerLocation::FindNearbyLocation(AActor* PlayerActor, FVector& OutLo
 		}
 		
 		// Find random point in navigable radius
-		if (NavSys->GetRandomReachablePointInRadius(OriginLocation, SearchRadius, ResultLocation))
+		if (NavSys.GetRandomReachablePointInRadius(OriginLocation, SearchRadius, ResultLocation))
 		{
 			FVector PotentialLocation = ResultLocation.Location;
 			
@@ -151,30 +269,14 @@ bool UFindPlayerLocation::FindNearbyLocation(AActor* PlayerActor, FVector& OutLo
 				continue; // Too close to player, try again
 			}
 			
-			// Check the line of sight if required
-			if (RequireLineOfSight)
+			// Known dead end: a recent path towards this spot failed
+			if (CompanionWorld && CompanionWorld->IsUnreachable(PotentialLocation))
 			{
-				FHitResult HitResult;
-				bool bHasLineOfSight = !World->LineTraceTestByChannel(
-					PlayerLocation,
-					PotentialLocation,
-					ECC_Visibility,
-					FCollisionQueryParams(TEXT("LineOfSight"), true, PlayerActor)
-				);
-				
-				if (!bHasLineOfSight)
-				{
-					if (DrawDebugPoints)
-					{
-						DrawDebugSphere(World, PotentialLocation, 20.0f, 8, FColor::Yellow, false, DebugDuration);
-						DrawDebugLine(World, PlayerLocation, PotentialLocation, FColor::Yellow, false, DebugDuration);
-					}
-					continue; // No line of sight, try again
-				}
+				continue;
 			}
 			
 			// Check if this location has been used recently
-			if (AvoidPreviousLocations && HasLocationBeenUsedRecently(PotentialLocation))
+			if (Visited && Visited->IsVisited(PotentialLocation, World->GetTimeSeconds()))
 			{
 				if (DrawDebugPoints)
 				{
@@ -183,40 +285,293 @@ bool UFindPlayerLocation::FindNearbyLocation(AActor* PlayerActor, FVector& OutLo
 				continue; // Location used recently, try again
 			}
 			
-			// Found a valid location
-			OutLocation = PotentialLocation;
-			
-			// Add to previous locations if needed
-			if (AvoidPreviousLocations)
+			OutCandidates.Add(PotentialLocation);
+		}
+	}
+}
+
+void UFindPlayerLocation::GatherScoredCandidates(AActor* PlayerActor, UNavigationSystemV1& NavSys, TArray<FVector>& OutCandidates) const
+{
+	UWorld* World = GetWorld();
+	
+	struct FCandidate
+	{
+		FVector Location;
+		float Score;
+	};
+	
+	const FVector PlayerLocation = PlayerActor->GetActorLocation();
+	const FCompanionVisitedGrid* Visited = FindVisitedGrid(PlayerActor);
+	const UCompanionWorldSubsystem* CompanionWorld = World->GetSubsystem<UCompanionWorldSubsystem>();
+	const float MinRadius = FMath::Min(MinDistanceFromPlayer, SearchRadius);
+	const int32 NumCandidates = FMath::Clamp(CandidateCount, 1, 32);
+	
+	// Preferred direction on the ground plane (zero when there is none to score against)
+	const FVector PreferredDirection = GetPreferredDirection(PlayerActor);
+	
+	// Spread candidates evenly over the search ring and project them onto the navmesh
+	TArray<FCandidate, TInlineAllocator<32>> Candidates;
+	const float AngleOffset = FMath::FRand() * UE_TWO_PI;
+	const float GoldenAngle = UE_PI * (3.0f - FMath::Sqrt(5.0f));
+	for (int32 i = 0; i < NumCandidates; ++i)
+	{
+		// Area-uniform radius between the minimum distance and the search radius
+		const float Alpha = (i + 0.5f) / NumCandidates;
+		const float Radius = FMath::Sqrt(FMath::Lerp(FMath::Square(MinRadius), FMath::Square(SearchRadius), Alpha));
+		const float Angle = AngleOffset + i * GoldenAngle;
+		const FVector Point = PlayerLocation + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * Radius;
+		
+		FNavLocation Projected;
+		if (!NavSys.ProjectPointToNavigation(Point, Projected))
+		{
+			continue;
+		}
+		
+		// Known dead end: a recent path towards this spot failed
+		if (CompanionWorld && CompanionWorld->IsUnreachable(Projected.Location))
+		{
+			continue;
+		}
+		
+		// Cheap filters first: personal space
+		const FVector Offset = Projected.Location - PlayerLocation;
+		const float DistanceToPlayer = Offset.Size2D();
+		if (DistanceToPlayer < MinDistanceFromPlayer)
+		{
+			if (DrawDebugPoints)
 			{
-				if (PreviousLocations.Num() >= LocationMemorySize)
-				{
-					PreviousLocations.RemoveAt(0);
-				}
-				PreviousLocations.Add(PotentialLocation);
+				DrawDebugSphere(World, Projected.Location, 20.0f, 8, FColor::Red, false, DebugDuration);
 			}
-			
+			continue;
+		}
+		
+		// Score: closeness to the player, directional preference and distance from previously used points
+		float Score = DistanceWeight * (1.0f - FMath::Clamp((DistanceToPlayer - MinRadius) / FMath::Max(SearchRadius - MinRadius, 1.0f), 0.0f, 1.0f));
+		if (!PreferredDirection.IsZero())
+		{
+			Score += DirectionWeight * 0.5f * (1.0f + FVector::DotProduct(Offset.GetSafeNormal2D(), PreferredDirection));
+		}
+		if (Visited)
+		{
+			// Graded by how much of the surrounding 3x3 cells was visited, not just the candidate's own cell
+			Score += NoveltyWeight * (1.0f - Visited->CountVisitedAround(Projected.Location, World->GetTimeSeconds()) / 9.0f);
+		}
+		
+		Candidates.Add({ Projected.Location, Score });
+	}
+	
+	// Expensive checks run best-first, so hand the candidates over in score order
+	Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.Score > B.Score; });
+	for (const FCandidate& Candidate : Candidates)
+	{
+		OutCandidates.Add(Candidate.Location);
+	}
+}
+
+void UFindPlayerLocation::RunSearch(const TSharedRef<FFindPlayerLocationSearch>& Search)
+{
+	UBehaviorTreeComponent* OwnerComp = Search->OwnerComp.Get();
+	if (!OwnerComp)
+	{
+		return;
+	}
+	
+	if (!Search->Player.IsValid() || !GatherCandidates(Search->Player.Get(), Search->Candidates))
+	{
+		FinishLatentTask(*OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+	
+	if (RequireLineOfSight)
+	{
+		// Traces resolve with the async scene queries next frame; the task stays in progress until then
+		RequestLineOfSightTraces(Search);
+	}
+	else
+	{
+		FinishSearch(*Search);
+	}
+}
+
+void UFindPlayerLocation::RequestLineOfSightTraces(const TSharedRef<FFindPlayerLocationSearch>& Search)
+{
+	UWorld* World = GetWorld();
+	AActor* PlayerActor = Search->Player.Get();
+	
+	FTraceDelegate OnTraceDone = FTraceDelegate::CreateWeakLambda(this, [this, WeakSearch = Search.ToWeakPtr()](const FTraceHandle& Handle, FTraceDatum& Datum)
+	{
+		// Results of an aborted or finished search find nothing to pin
+		const TSharedPtr<FFindPlayerLocationSearch> Pinned = WeakSearch.Pin();
+		if (!Pinned || !Pinned->Blocked.IsValidIndex(Datum.UserData))
+		{
+			return;
+		}
+		
+		Pinned->Blocked[Datum.UserData] = Datum.OutHits.Num() > 0;
+		if (--Pinned->PendingTraces == 0)
+		{
+			FinishSearch(*Pinned);
+		}
+	});
+	
+	// One trace per candidate, all resolved in the same async batch
+	const FVector PlayerLocation = PlayerActor->GetActorLocation();
+	const FCollisionQueryParams TraceParams(TEXT("LineOfSight"), true, PlayerActor);
+	Search->Blocked.Init(false, Search->Candidates.Num());
+	Search->PendingTraces = Search->Candidates.Num();
+	for (int32 i = 0; i < Search->Candidates.Num(); ++i)
+	{
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Test, PlayerLocation, Search->Candidates[i], ECC_Visibility,
+			TraceParams, FCollisionResponseParams::DefaultResponseParam, &OnTraceDone, i);
+	}
+}
+
+void UFindPlayerLocation::FinishSearch(FFindPlayerLocationSearch& Search)
+{
+	UBehaviorTreeComponent* OwnerComp = Search.OwnerComp.Get();
+	if (!OwnerComp)
+	{
+		return;
+	}
+	
+	FVector TargetPlayerLocation;
+	const bool bFound = Search.Player.IsValid()
+		&& PickCandidate(Search.Player.Get(), Search.Candidates, RequireLineOfSight ? &Search.Blocked : nullptr, TargetPlayerLocation);
+	
+	if (bFound)
+	{
+		CommitLocation(*OwnerComp, TargetPlayerLocation);
+	}
+	FinishLatentTask(*OwnerComp, bFound ? EBTNodeResult::Succeeded : EBTNodeResult::Failed);
+}
+
+bool UFindPlayerLocation::PickCandidate(AActor* PlayerActor, TConstArrayView<FVector> Candidates, const TBitArray<>* Blocked, FVector& OutLocation)
+{
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	if (!World || !NavSys || !PlayerActor)
+	{
+		return false;
+	}
+	
+	for (int32 i = 0; i < Candidates.Num(); ++i)
+	{
+		// Line of sight comes from the async results when there are some, otherwise trace now
+		const bool bKnownBlocked = Blocked && (*Blocked)[i];
+		if (PassesExpensiveChecks(PlayerActor, Candidates[i], Blocked ? &bKnownBlocked : nullptr))
+		{
+			OutLocation = Candidates[i];
+			RememberLocation(PlayerActor, Candidates[i]);
 			return true;
 		}
 	}
 	
-	UE_LOG(LogTemp, Warning, TEXT("BTTask_FindPlayerLocation: Failed to find valid location after %d attempts"), MaxAttempts);
+	UE_LOG(LogTemp, Warning, TEXT("BTTask_FindPlayerLocation: No valid location among %d candidates"), Candidates.Num());
 	return false;
 }
 
-bool UFindPlayerLocation::HasLocationBeenUsedRecently(const FVector& Location) const
+bool UFindPlayerLocation::PassesExpensiveChecks(AActor* PlayerActor, const FVector& Candidate, const bool* bKnownBlocked) const
 {
-	const float MinDistanceBetweenLocations = 200.0f;
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	const FVector PlayerLocation = PlayerActor->GetActorLocation();
 	
-	for (const FVector& PreviousLocation : PreviousLocations)
+	const FCollisionQueryParams TraceParams(TEXT("LineOfSight"), true, PlayerActor);
+	const bool bBlocked = bKnownBlocked
+		? *bKnownBlocked
+		: RequireLineOfSight && World->LineTraceTestByChannel(PlayerLocation, Candidate, ECC_Visibility, TraceParams);
+	if (bBlocked)
 	{
-		if (FVector::Dist(Location, PreviousLocation) < MinDistanceBetweenLocations)
+		if (DrawDebugPoints)
 		{
-			return true; // Too close to a previously used location
+			DrawDebugSphere(World, Candidate, 20.0f, 8, FColor::Yellow, false, DebugDuration);
+			DrawDebugLine(World, PlayerLocation, Candidate, FColor::Yellow, false, DebugDuration);
 		}
+		return false;
 	}
 	
-	return false;
+	// Projection alone does not guarantee the point connects to the player's nav area
+	const ANavigationData* NavData = NavSys ? NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) : nullptr;
+	if (RequireNavigablePath && NavData)
+	{
+		const FPathFindingQuery Query(PlayerActor, *NavData, PlayerLocation, Candidate);
+		if (!NavSys->TestPathSync(Query, EPathFindingMode::Hierarchical))
+		{
+			// Share the failure so no companion tests this spot again for a while
+			if (UCompanionWorldSubsystem* CompanionWorld = World->GetSubsystem<UCompanionWorldSubsystem>())
+			{
+				CompanionWorld->MarkUnreachable(Candidate);
+			}
+			if (DrawDebugPoints)
+			{
+				DrawDebugSphere(World, Candidate, 20.0f, 8, FColor::Orange, false, DebugDuration);
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+bool UFindPlayerLocation::IsFollowSlotUsable(AActor* PlayerActor, const FVector& SlotLocation) const
+{
+	// Ring slots are projected onto the navmesh already; check what the search itself would filter on
+	const FVector Offset = SlotLocation - PlayerActor->GetActorLocation();
+	const float DistanceToPlayer = Offset.Size2D();
+	if (DistanceToPlayer < MinDistanceFromPlayer || DistanceToPlayer > SearchRadius)
+	{
+		return false;
+	}
+	
+	const FVector PreferredDirection = GetPreferredDirection(PlayerActor);
+	if (!PreferredDirection.IsZero() && FVector::DotProduct(Offset.GetSafeNormal2D(), PreferredDirection) <= 0.0f)
+	{
+		return false;
+	}
+	
+	const UCompanionWorldSubsystem* CompanionWorld = GetWorld()->GetSubsystem<UCompanionWorldSubsystem>();
+	if (CompanionWorld && CompanionWorld->IsUnreachable(SlotLocation))
+	{
+		return false;
+	}
+	
+	return PassesExpensiveChecks(PlayerActor, SlotLocation, nullptr);
+}
+
+FVector UFindPlayerLocation::GetPreferredDirection(AActor* PlayerActor) const
+{
+	FVector PreferredDirection = FVector::ZeroVector;
+	if (UseDirectionalBias)
+	{
+		switch (DirectionalPreference)
+		{
+			case EPositioningPreference::InFront: PreferredDirection = PlayerActor->GetActorForwardVector();  break;
+			case EPositioningPreference::Behind:  PreferredDirection = -PlayerActor->GetActorForwardVector(); break;
+			case EPositioningPreference::ToLeft:  PreferredDirection = -PlayerActor->GetActorRightVector();   break;
+			case EPositioningPreference::ToRight: PreferredDirection = PlayerActor->GetActorRightVector();    break;
+			default: break;
+		}
+	}
+	return PreferredDirection.GetSafeNormal2D();
+}
+
+FCompanionVisitedGrid* UFindPlayerLocation::FindVisitedGrid(AActor* PlayerActor) const
+{
+	UWorld* World = GetWorld();
+	if (!AvoidPreviousLocations || !World || !PlayerActor)
+	{
+		return nullptr;
+	}
+	
+	UCompanionWorldSubsystem* CompanionWorld = World->GetSubsystem<UCompanionWorldSubsystem>();
+	return CompanionWorld ? &CompanionWorld->GetVisitedGrid(PlayerActor) : nullptr;
+}
+
+void UFindPlayerLocation::RememberLocation(AActor* PlayerActor, const FVector& Location) const
+{
+	if (FCompanionVisitedGrid* Visited = FindVisitedGrid(PlayerActor))
+	{
+		Visited->Mark(Location, GetWorld()->GetTimeSeconds());
+	}
 }
 
 FVector UFindPlayerLocation::ApplyDirectionalBias(AActor* PlayerActor, const FVector& OriginLocation, float Distance) const
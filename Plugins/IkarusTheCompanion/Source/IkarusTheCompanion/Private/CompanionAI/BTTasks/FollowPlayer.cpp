@@ -3,8 +3,14 @@
 
 #include "CompanionAI/BTTasks/FollowPlayer.h"
 #include "AIController.h"
+#include "BrainComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
 #include "Navigation/PathFollowingComponent.h"
+#include "NavigationSystem.h"
+#include "NavigationData.h"
+#include "CompanionAI/CompanionControllers/AICompanionController.h"
+#include "CompanionAI/Subsystems/CompanionWorldSubsystem.h"
 
 UFollowPlayer::UFollowPlayer(FObjectInitializer const& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -12,7 +18,7 @@ UFollowPlayer::UFollowPlayer(FObjectInitializer const& ObjectInitializer)
 	NodeName = TEXT("Follow Player Task");
 	bNotifyTick = true;
 	bNotifyTaskFinished = true;
-	bCreateNodeInstance = true; // Important for proper task instancing
+	// Not instanced: per-companion state lives in FFollowPlayerMemory
 
 	BlackboardKey.AddVectorFilter(
 		this, GET_MEMBER_NAME_CHECKED(UFollowPlayer, BlackboardKey));
@@ -28,148 +34,432 @@ EBTNodeResult::Type UFollowPlayer::ExecuteTask(
 		return EBTNodeResult::Failed;
 	}
 
+	FFollowPlayerMemory* Memory = CastInstanceNodeMemory<FFollowPlayerMemory>(NodeMemory);
+	Memory->TimeSinceRepathCheck = 0.f;
+
 	// Get target from blackboard
-	CachedTarget = OwnerComp.GetBlackboardComponent()->GetValueAsVector(GetSelectedBlackboardKey());
+	Memory->CachedTarget = OwnerComp.GetBlackboardComponent()->GetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID());
 
-	// Start the move request
-	if (StartMoveRequest(Controller, CachedTarget))
+	// Recent failures towards this spot, ours or another companion's: don't burn another path query on it,
+	// stay in progress and retry from TickTask once the backoff runs out or the goal moves
+	Memory->bWaitingToRetry = ShouldSkipPath(OwnerComp, *Memory, Memory->CachedTarget);
+	if (Memory->bWaitingToRetry)
 	{
 		return EBTNodeResult::InProgress;
 	}
-	
-	return EBTNodeResult::Failed;
+
+	// Start the move request
+	return RequestMove(OwnerComp, *Controller, *Memory);
 }
 
 void UFollowPlayer::TickTask(
 	UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
 {
+	FFollowPlayerMemory* Memory = CastInstanceNodeMemory<FFollowPlayerMemory>(NodeMemory);
+
+	auto* Controller = Cast<AAIController>(OwnerComp.GetAIOwner());
+	if (!Controller)
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+
+	// Backing off: start moving once we may path again towards wherever the target is now
+	if (Memory->bWaitingToRetry)
+	{
+		const FVector Target = OwnerComp.GetBlackboardComponent()->GetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID());
+		if (ShouldSkipPath(OwnerComp, *Memory, Target))
+		{
+			return;
+		}
+		Memory->bWaitingToRetry = false;
+		Memory->CachedTarget = Target;
+
+		const EBTNodeResult::Type Result = RequestMove(OwnerComp, *Controller, *Memory);
+		if (Result != EBTNodeResult::InProgress)
+		{
+			FinishLatentTask(OwnerComp, Result);
+		}
+		return;
+	}
+
 	// Only update if we're actively moving
-	if (!bIsMoveActive)
+	if (!Memory->MoveRequestID.IsValid())
 	{
 		return;
 	}
 
-	auto* Controller = Cast<AAIController>(OwnerComp.GetAIOwner());
-	if (!Controller)
+	// A path query that landed since the last tick takes over the move, whatever the LOD throttle says
+	if (Memory->PathQuery.IsValid() && Memory->PathQuery->bFinished)
 	{
-		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		const TSharedPtr<FFollowPlayerPathQuery> PathQuery = MoveTemp(Memory->PathQuery);
+		OnPathFound(OwnerComp, *Memory, *PathQuery);
 		return;
 	}
 
-	const FVector NewTarget = OwnerComp.GetBlackboardComponent()->GetValueAsVector(GetSelectedBlackboardKey());
+	// Lower AI LOD buckets check for repaths less often
+	Memory->TimeSinceRepathCheck += DeltaSeconds;
+	if (const AAICompanionController* Companion = Cast<AAICompanionController>(Controller))
+	{
+		if (Memory->TimeSinceRepathCheck < Companion->GetAILODSettings().TaskTickInterval)
+		{
+			return;
+		}
+	}
+	Memory->TimeSinceRepathCheck = 0.f;
+
+	const FVector NewTarget = OwnerComp.GetBlackboardComponent()->GetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID());
 
 	// Check if the target has moved beyond our threshold
-	if (FVector::DistSquared(NewTarget, CachedTarget) > FMath::Square(RepathThreshold))
-	{
-		CachedTarget = NewTarget;
-		
-		// Request a new move with the updated target
-		FAIMoveRequest MoveRequest(CachedTarget);
-		MoveRequest.SetAcceptanceRadius(AcceptanceRadius);
-		MoveRequest.SetAllowPartialPath(bAllowPartialPath);
-		MoveRequest.SetUsePathfinding(true);
-		MoveRequest.SetProjectGoalLocation(true);
-		MoveRequest.SetCanStrafe(bCanStrafe);
-		MoveRequest.SetNavigationFilter(NavFilter);
-
-		// Stop current movement and start new request
-		if (bIsMoveActive && CurrentMoveRequestID.IsValid())
+	if (FVector::DistSquared(NewTarget, Memory->CachedTarget) > FMath::Square(RepathThreshold))
+	{
+		// Keep following the current path rather than re-planning towards a known dead end
+		if (ShouldSkipPath(OwnerComp, *Memory, NewTarget))
 		{
-			Controller->StopMovement();
+			return;
+		}
+
+		if (bAsyncRepath)
+		{
+			// A query is already on its way: keep following the current path until it lands
+			if (Memory->PathQuery.IsValid())
+			{
+				return;
+			}
+
+			// Only the goal end shifted: bend the current path instead of planning a new one
+			if (TrySplicePath(*Controller, *Memory, NewTarget))
+			{
+				Memory->CachedTarget = NewTarget;
+				Memory->MoveGoal = NewTarget;
+				return;
+			}
+
+			// The current move keeps its goal until the new path lands
+			if (RequestPathAsync(OwnerComp, *Controller, *Memory, NewTarget))
+			{
+				Memory->CachedTarget = NewTarget;
+				return;
+			}
+		}
+
+		Memory->CachedTarget = NewTarget;
+
+		// The new request replaces the current one; only its completion message matters from here on
+		const EBTNodeResult::Type Result = RequestMove(OwnerComp, *Controller, *Memory);
+		if (Result != EBTNodeResult::InProgress)
+		{
+			FinishLatentTask(OwnerComp, Result);
 		}
-		
-		// Start new move request
-		CleanupDelegates(Controller);
-		Controller->ReceiveMoveCompleted.AddDynamic(this, &UFollowPlayer::HandleMoveFinished);
-		CurrentMoveRequestID = Controller->MoveTo(MoveRequest);
-		bIsMoveActive = CurrentMoveRequestID.IsValid();
 	}
 }
 
 void UFollowPlayer::OnTaskFinished(
 	UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
 {
-	if (auto* Controller = Cast<AAIController>(OwnerComp.GetAIOwner()))
-	{
-		CleanupDelegates(Controller);
-	}
-	
-	bIsMoveActive = false;
-	CurrentMoveRequestID = FAIRequestID();
-	
+	FFollowPlayerMemory* Memory = CastInstanceNodeMemory<FFollowPlayerMemory>(NodeMemory);
+	AbortPathQuery(OwnerComp, *Memory);
+	Memory->MoveRequestID = FAIRequestID::InvalidRequest;
+	Memory->bWaitingToRetry = false;
+
 	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
 }
 
 EBTNodeResult::Type UFollowPlayer::AbortTask(
 	UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
+	FFollowPlayerMemory* Memory = CastInstanceNodeMemory<FFollowPlayerMemory>(NodeMemory);
+
+	// Stop listening first: the stopped move reports back as a failed finish
+	StopWaitingForMessages(OwnerComp);
+	AbortPathQuery(OwnerComp, *Memory);
+
 	if (auto* Controller = Cast<AAIController>(OwnerComp.GetAIOwner()))
 	{
-		if (bIsMoveActive && CurrentMoveRequestID.IsValid())
+		// Only stop the move if it is still ours
+		UPathFollowingComponent* PathFollowing = Controller->GetPathFollowingComponent();
+		if (Memory->MoveRequestID.IsValid() && PathFollowing && PathFollowing->GetCurrentRequestId() == Memory->MoveRequestID)
 		{
 			Controller->StopMovement();
 		}
-		CleanupDelegates(Controller);
 	}
-	
-	bIsMoveActive = false;
-	CurrentMoveRequestID = FAIRequestID();
-	
+
+	Memory->MoveRequestID = FAIRequestID::InvalidRequest;
+	Memory->bWaitingToRetry = false;
+
 	return EBTNodeResult::Aborted;
 }
 
-void UFollowPlayer::HandleMoveFinished(
-	FAIRequestID RequestID, EPathFollowingResult::Type Result)
+void UFollowPlayer::OnMessage(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, FName Message, int32 RequestID, bool bSuccess)
 {
-	// Only handle if this is our current request
-	if (RequestID != CurrentMoveRequestID)
+	if (Message == UBrainComponent::AIMessage_MoveFinished)
 	{
-		return;
+		FFollowPlayerMemory* Memory = CastInstanceNodeMemory<FFollowPlayerMemory>(NodeMemory);
+		// Credit or blame the goal this move went to, not a newer target whose path is still pending
+		bool bGoalUnreachable = false;
+		if (bSuccess)
+		{
+			NotePathSucceeded(OwnerComp, *Memory, Memory->MoveGoal);
+		}
+		else if (IsMoveFailure(OwnerComp, RequestID, bGoalUnreachable))
+		{
+			// Aborted moves (stopped, replaced, paused) say nothing about the goal
+			NotePathFailed(OwnerComp, *Memory, Memory->MoveGoal, bGoalUnreachable);
+		}
 	}
 
-	bIsMoveActive = false;
-	
-	// Notify the behavior tree we're done
-	if (auto* BehaviorComp = Cast<UBehaviorTreeComponent>(GetOuter()))
-	{
-		FinishLatentTask(*BehaviorComp, 
-			Result == EPathFollowingResult::Success ? EBTNodeResult::Succeeded : EBTNodeResult::Failed);
-	}
+	Super::OnMessage(OwnerComp, NodeMemory, Message, RequestID, bSuccess);
 }
 
-bool UFollowPlayer::StartMoveRequest(AAIController* Controller, const FVector& Target)
+uint16 UFollowPlayer::GetInstanceMemorySize() const
 {
-	if (!Controller || bIsMoveActive)
-	{
-		return false;
-	}
+	return sizeof(FFollowPlayerMemory);
+}
 
-	// Clean up any existing delegates first
-	CleanupDelegates(Controller);
+void UFollowPlayer::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FFollowPlayerMemory>(NodeMemory, InitType);
+}
 
-	// Setup move request
-	FAIMoveRequest MoveRequest(Target);
+void UFollowPlayer::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FFollowPlayerMemory>(NodeMemory, CleanupType);
+}
+
+FAIMoveRequest UFollowPlayer::MakeMoveRequest(const FVector& Goal) const
+{
+	FAIMoveRequest MoveRequest(Goal);
 	MoveRequest.SetAcceptanceRadius(AcceptanceRadius);
 	MoveRequest.SetAllowPartialPath(bAllowPartialPath);
 	MoveRequest.SetUsePathfinding(true);
 	MoveRequest.SetProjectGoalLocation(true);
 	MoveRequest.SetCanStrafe(bCanStrafe);
 	MoveRequest.SetNavigationFilter(NavFilter);
+	return MoveRequest;
+}
+
+EBTNodeResult::Type UFollowPlayer::RequestMove(UBehaviorTreeComponent& OwnerComp, AAIController& Controller, FFollowPlayerMemory& Memory) const
+{
+	const FAIMoveRequest MoveRequest = MakeMoveRequest(Memory.CachedTarget);
+
+	// Drop the wait on any previous request before its aborted move reports back
+	StopWaitingForMessages(OwnerComp);
 
-	// Bind to completion delegate
-	Controller->ReceiveMoveCompleted.AddDynamic(this, &UFollowPlayer::HandleMoveFinished);
-	
 	// Start the move
-	CurrentMoveRequestID = Controller->MoveTo(MoveRequest);
-	bIsMoveActive = CurrentMoveRequestID.IsValid();
-	
-	return bIsMoveActive;
+	const FPathFollowingRequestResult Result = Controller.MoveTo(MoveRequest);
+	switch (Result.Code)
+	{
+		case EPathFollowingRequestResult::RequestSuccessful:
+			// The path following component reports completion through the BT message system
+			Memory.MoveRequestID = Result.MoveId;
+			Memory.MoveGoal = Memory.CachedTarget;
+			WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, Result.MoveId);
+			return EBTNodeResult::InProgress;
+
+		case EPathFollowingRequestResult::AlreadyAtGoal:
+			Memory.MoveRequestID = FAIRequestID::InvalidRequest;
+			Memory.MoveGoal = Memory.CachedTarget;
+			NotePathSucceeded(OwnerComp, Memory, Memory.CachedTarget);
+			return EBTNodeResult::Succeeded;
+
+		default:
+			// MoveTo only fails this way when no path could be found towards the goal
+			Memory.MoveRequestID = FAIRequestID::InvalidRequest;
+			NotePathFailed(OwnerComp, Memory, Memory.CachedTarget, true);
+			return EBTNodeResult::Failed;
+	}
 }
 
-void UFollowPlayer::CleanupDelegates(AAIController* Controller)
+bool UFollowPlayer::TrySplicePath(AAIController& Controller, const FFollowPlayerMemory& Memory, const FVector& NewTarget) const
 {
-	if (Controller)
+	// Only bend a complete path that is still the one we asked for
+	UPathFollowingComponent* PathFollowing = Controller.GetPathFollowingComponent();
+	if (SpliceDistance <= 0.f || !PathFollowing || PathFollowing->GetCurrentRequestId() != Memory.MoveRequestID)
 	{
-		Controller->ReceiveMoveCompleted.RemoveDynamic(this, &UFollowPlayer::HandleMoveFinished);
+		return false;
+	}
+
+	FNavPathSharedPtr Path = PathFollowing->GetPath();
+	if (!Path.IsValid() || !Path->IsValid() || Path->IsPartial() || Path->GetPathPoints().Num() < 2)
+	{
+		return false;
+	}
+
+	TArray<FNavPathPoint>& Points = Path->GetPathPoints();
+	const FVector OldGoal = Points.Last().Location;
+	const ANavigationData* NavData = Path->GetNavigationDataUsed();
+	if (!NavData || FVector::DistSquared(OldGoal, NewTarget) > FMath::Square(SpliceDistance))
+	{
+		return false;
+	}
+
+	FNavLocation Goal;
+	FSharedConstNavQueryFilter Filter = UNavigationQueryFilter::GetQueryFilter(*NavData, &Controller, NavFilter);
+	if (!NavData->ProjectPoint(NewTarget, Goal, NavData->GetConfig().DefaultQueryExtent, Filter, &Controller))
+	{
+		return false;
 	}
-}
\ No newline at end of file
+
+	// Straight from the last corner: move the end point. Straight from the old end: add one segment.
+	FVector HitLocation;
+	if (!NavData->Raycast(Points[Points.Num() - 2].Location, Goal.Location, HitLocation, Filter, &Controller))
+	{
+		Points.Last() = FNavPathPoint(Goal.Location, Goal.NodeRef);
+	}
+	else if (!NavData->Raycast(OldGoal, Goal.Location, HitLocation, Filter, &Controller))
+	{
+		Points.Add(FNavPathPoint(Goal.Location, Goal.NodeRef));
+	}
+	else
+	{
+		return false;
+	}
+
+	// Path following picks the change up like an engine goal-moved update, keeping the same move request
+	Path->DoneUpdating(ENavPathUpdateType::GoalMoved);
+	return true;
+}
+
+bool UFollowPlayer::RequestPathAsync(UBehaviorTreeComponent& OwnerComp, AAIController& Controller, FFollowPlayerMemory& Memory, const FVector& NewTarget) const
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(Controller.GetWorld());
+	FPathFindingQuery Query;
+	if (!NavSys || !Controller.BuildPathfindingQuery(MakeMoveRequest(NewTarget), Query))
+	{
+		return false;
+	}
+
+	// The callback only fills in the shared query; node memory may be gone or reused by the time it runs
+	const TSharedRef<FFollowPlayerPathQuery> PathQuery = MakeShared<FFollowPlayerPathQuery>();
+	PathQuery->Goal = NewTarget;
+	PathQuery->QueryID = NavSys->FindPathAsync(Controller.GetNavAgentPropertiesRef(), Query,
+		FNavPathQueryDelegate::CreateLambda([WeakQuery = PathQuery.ToWeakPtr()](uint32 QueryID, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+		{
+			if (const TSharedPtr<FFollowPlayerPathQuery> Pinned = WeakQuery.Pin())
+			{
+				Pinned->bFinished = true;
+				Pinned->Result = Result;
+				Pinned->Path = Path;
+			}
+		}));
+
+	if (PathQuery->QueryID == INVALID_NAVQUERYID)
+	{
+		return false;
+	}
+	Memory.PathQuery = PathQuery;
+	return true;
+}
+
+void UFollowPlayer::OnPathFound(UBehaviorTreeComponent& OwnerComp, FFollowPlayerMemory& Memory, const FFollowPlayerPathQuery& PathQuery) const
+{
+	AAIController* Controller = OwnerComp.GetAIOwner();
+	if (!Controller)
+	{
+		return;
+	}
+
+	// No new path: keep following the old one; the backoff and unreachable mark hold off the next attempt
+	const FNavPathSharedPtr Path = PathQuery.Path;
+	if (PathQuery.Result != ENavigationQueryResult::Success || !Path.IsValid())
+	{
+		NotePathFailed(OwnerComp, Memory, PathQuery.Goal, true);
+		return;
+	}
+
+	Path->EnableRecalculationOnInvalidation(true);
+
+	// Swap paths without stopping; the replaced request reports back as aborted, which we no longer listen to
+	StopWaitingForMessages(OwnerComp);
+	Memory.MoveRequestID = Controller->RequestMove(MakeMoveRequest(PathQuery.Goal), Path);
+	if (!Memory.MoveRequestID.IsValid())
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+	Memory.MoveGoal = PathQuery.Goal;
+	WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, Memory.MoveRequestID);
+}
+
+void UFollowPlayer::AbortPathQuery(UBehaviorTreeComponent& OwnerComp, FFollowPlayerMemory& Memory) const
+{
+	if (!Memory.PathQuery.IsValid())
+	{
+		return;
+	}
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(OwnerComp.GetWorld());
+	if (NavSys && !Memory.PathQuery->bFinished)
+	{
+		NavSys->AbortAsyncFindPathRequest(Memory.PathQuery->QueryID);
+	}
+	Memory.PathQuery.Reset();
+}
+
+bool UFollowPlayer::ShouldSkipPath(UBehaviorTreeComponent& OwnerComp, const FFollowPlayerMemory& Memory, const FVector& Goal) const
+{
+	UWorld* World = OwnerComp.GetWorld();
+	if (!World)
+	{
+		return false;
+	}
+
+	if (World->GetTimeSeconds() < Memory.RetryAfter)
+	{
+		return true;
+	}
+
+	const UCompanionWorldSubsystem* CompanionWorld = World->GetSubsystem<UCompanionWorldSubsystem>();
+	return CompanionWorld && CompanionWorld->IsUnreachable(Goal);
+}
+
+bool UFollowPlayer::IsMoveFailure(UBehaviorTreeComponent& OwnerComp, int32 RequestID, bool& bOutGoalUnreachable) const
+{
+	// Only companions keep the full result around; without it an unsuccessful move is not held against the goal
+	const AAICompanionController* Companion = Cast<AAICompanionController>(OwnerComp.GetAIOwner());
+	const FPathFollowingResult* Result = Companion ? Companion->FindMoveResult(FAIRequestID(RequestID)) : nullptr;
+	if (!Result || !Result->IsFailure() || Result->Code == EPathFollowingResult::Aborted)
+	{
+		bOutGoalUnreachable = false;
+		return false;
+	}
+
+	// Blocked or pushed off the path is this companion's problem (often another follower in the way), not the goal's
+	bOutGoalUnreachable = Result->Code == EPathFollowingResult::Invalid || Result->HasFlag(FPathFollowingResultFlags::InvalidPath);
+	return true;
+}
+
+void UFollowPlayer::NotePathFailed(UBehaviorTreeComponent& OwnerComp, FFollowPlayerMemory& Memory, const FVector& Goal, bool bGoalUnreachable) const
+{
+	UWorld* World = OwnerComp.GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// 1x, 2x, 4x... the base backoff, capped
+	Memory.ConsecutiveFailures = FMath::Min(Memory.ConsecutiveFailures + 1, 16);
+	const float Backoff = FMath::Min(FailureBackoff * static_cast<float>(1 << (Memory.ConsecutiveFailures - 1)), MaxFailureBackoff);
+	Memory.RetryAfter = World->GetTimeSeconds() + Backoff;
+
+	if (!bGoalUnreachable)
+	{
+		return;
+	}
+
+	if (UCompanionWorldSubsystem* CompanionWorld = World->GetSubsystem<UCompanionWorldSubsystem>())
+	{
+		CompanionWorld->MarkUnreachable(Goal);
+	}
+}
+
+void UFollowPlayer::NotePathSucceeded(UBehaviorTreeComponent& OwnerComp, FFollowPlayerMemory& Memory, const FVector& Goal) const
+{
+	Memory.ConsecutiveFailures = 0;
+	Memory.RetryAfter = 0.0;
+
+	if (UCompanionWorldSubsystem* CompanionWorld = OwnerComp.GetWorld() ? OwnerComp.GetWorld()->GetSubsystem<UCompanionWorldSubsystem>() : nullptr)
+	{
+		CompanionWorld->ClearUnreachable(Goal);
+	}
+}
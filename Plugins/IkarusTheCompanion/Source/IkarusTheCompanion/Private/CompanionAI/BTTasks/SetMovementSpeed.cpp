@@ -1,6 +1,7 @@
 
 #include "CompanionAI/BTTasks/SetMovementSpeed.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
 #include "CompanionAI/IkarusCharacter.h"
 #include "CompanionAI/CompanionControllers/AICompanionController.h"
@@ -15,6 +16,17 @@ USetMovementSpeed::USetMovementSpeed(const FObjectInitializer& ObjectInitializer
 		GET_MEMBER_NAME_CHECKED(USetMovementSpeed, DebugSpeedKey));
 }
 
+void USetMovementSpeed::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (const UBlackboardData* BBAsset = GetBlackboardAsset())
+	{
+		CompanionProximityKey.ResolveSelectedKey(*BBAsset);
+		DebugSpeedKey.ResolveSelectedKey(*BBAsset);
+	}
+}
+
 EBTNodeResult::Type USetMovementSpeed::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
 	if (auto* Controller = Cast<AAICompanionController>(OwnerComp.GetAIOwner()))
@@ -26,18 +38,19 @@ EBTNodeResult::Type USetMovementSpeed::ExecuteTask(UBehaviorTreeComponent& Owner
 			if (bAutomaticFromDistance)
 			{
 				const float Prox =
-					OwnerComp.GetBlackboardComponent()->GetValueAsFloat(
-						CompanionProximityKey.SelectedKeyName);
+					OwnerComp.GetBlackboardComponent()->GetValue<UBlackboardKeyType_Float>(
+						CompanionProximityKey.GetSelectedKeyID());
 				DesiredSpeed = ProximityToEnum(Prox);
 			}
 
 			float OutSpeed = 0.f;
 			Companion->SetMovementSpeed(DesiredSpeed, OutSpeed);
 
-			if (DebugSpeedKey.SelectedKeyType == UBlackboardKeyType_Float::StaticClass())
+			if (DebugSpeedKey.SelectedKeyType == UBlackboardKeyType_Float::StaticClass()
+				&& DebugSpeedKey.IsSet())
 			{
-				OwnerComp.GetBlackboardComponent()->SetValueAsFloat(
-					DebugSpeedKey.SelectedKeyName, OutSpeed);
+				OwnerComp.GetBlackboardComponent()->SetValue<UBlackboardKeyType_Float>(
+					DebugSpeedKey.GetSelectedKeyID(), OutSpeed);
 			}
 
 			return EBTNodeResult::Succeeded;
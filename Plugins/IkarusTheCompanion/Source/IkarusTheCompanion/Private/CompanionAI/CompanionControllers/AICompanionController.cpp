@@ -1,17 +1,25 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "IkarusTheCompanion/Public/CompanionAI/CompanionControllers/AICompanionController.h"
+#include "CompanionAI/Subsystems/CompanionWorldSubsystem.h"
+#include "CompanionCore/CoreData/CompanionBlackboardDefaults.h"
+#include "CompanionCore/CoreData/CompanionPerceptionProfile.h"
+#include "CompanionCore/CoreTags/CompanionGameplayTags.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
 #include "GameFramework/Character.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "Navigation/PathFollowingComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Perception/AIPerceptionComponent.h"
 #include "Perception/AISenseConfig_Sight.h"
 #include "Perception/AISenseConfig_Hearing.h"
+#include "Perception/AISense_Sight.h"
+#include "Perception/AISense_Hearing.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/World.h"
-#include "TimerManager.h"
 
 // Sets default values
 AAICompanionController::AAICompanionController()
@@ -24,6 +32,24 @@ AAICompanionController::AAICompanionController()
     BehaviorTreeComponent = CreateDefaultSubobject<UBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
     BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("BlackboardComponent"));
     
+    // Default AI LOD buckets: High, Medium, Low, Dormant
+    auto MakeLOD = [](float MaxDistance, float BBInterval, float ServiceScale, float TaskTick, float MoveTick, float PerceptionScale, bool bPerception)
+    {
+        FCompanionAILODSettings Settings;
+        Settings.MaxDistance = MaxDistance;
+        Settings.BlackboardUpdateInterval = BBInterval;
+        Settings.ServiceIntervalScale = ServiceScale;
+        Settings.TaskTickInterval = TaskTick;
+        Settings.MovementTickInterval = MoveTick;
+        Settings.PerceptionRadiusScale = PerceptionScale;
+        Settings.bPerceptionEnabled = bPerception;
+        return Settings;
+    };
+    AILODSettings.Add(MakeLOD(2500.f,   0.1f,  1.f, 0.f,   0.f,    1.f,   true));
+    AILODSettings.Add(MakeLOD(5000.f,   0.25f, 2.f, 0.1f,  0.033f, 0.75f, true));
+    AILODSettings.Add(MakeLOD(10000.f,  0.5f,  4.f, 0.25f, 0.1f,   0.5f,  true));
+    AILODSettings.Add(MakeLOD(FLT_MAX,  1.0f,  8.f, 0.5f,  0.25f,  0.f,   false));
+    
     // Setup perception system
     SetupPerceptionSystem();
 }
@@ -33,15 +59,11 @@ void AAICompanionController::BeginPlay()
 {
     Super::BeginPlay();
     
-    // Setup timer for optimized blackboard updates
-    if (GetWorld())
+    ThreatTracker.SetScoring(ThreatScoring);
+    
+    if (UPathFollowingComponent* PathFollowing = GetPathFollowingComponent())
     {
-        GetWorld()->GetTimerManager().SetTimer(
-            BlackboardUpdateTimerHandle,
-            this,
-            &AAICompanionController::UpdateBlackboardValues,
-            BlackboardUpdateInterval,
-            true);
+        PathFollowing->OnRequestFinished.AddUObject(this, &AAICompanionController::RecordMoveResult);
     }
 }
 
@@ -58,6 +80,10 @@ void AAICompanionController::OnPossess(APawn* InPawn)
 {
     Super::OnPossess(InPawn);
     
+    if (InPawn)
+    {
+        InPawn->OnTakeAnyDamage.AddUniqueDynamic(this, &AAICompanionController::OnPawnTakeAnyDamage);
+    }
     
     // Initialize and run behavior tree
     if (BehaviorTree && BlackboardComponent)
@@ -65,12 +91,41 @@ void AAICompanionController::OnPossess(APawn* InPawn)
         // Initialize blackboard with data asset
         if (BehaviorTree->BlackboardAsset && InitializeBlackboard(*BlackboardComponent, *BehaviorTree->BlackboardAsset))
         {
+            // Resolve key IDs once per asset; every read and write below goes through them
+            BlackboardKeys = &FCompanionBlackboardKeys::Get(*BlackboardComponent);
+            const FCompanionBlackboardKeys& Keys = *BlackboardKeys;
+            
             // Setup companion-specific blackboard values
             SetupCompanionBlackboardValues();
             
+            // Coming back from a virtual record: restore the state we had before collapsing
+            if (!PendingBlackboardRestore.IsEmpty())
+            {
+                PendingBlackboardRestore.Restore(*BlackboardComponent);
+                PendingBlackboardRestore.Reset();
+                
+                Keys.SelfActor.Set(BlackboardComponent, InPawn);
+                Keys.CompanionRef.Set(BlackboardComponent, InPawn);
+                if (PendingOwnerRestore.IsValid())
+                {
+                    SetOwnerPlayer(PendingOwnerRestore.Get());
+                }
+                PendingOwnerRestore.Reset();
+                
+                // Parked before collapsing: settle back into hibernation
+                ScheduleHibernation();
+            }
+            
             // Run behavior tree
             BehaviorTreeComponent->StartTree(*BehaviorTree);
             
+            // Blackboard refreshes are batched across all companions by the world subsystem
+            if (UCompanionWorldSubsystem* CompanionWorld = GetWorld()->GetSubsystem<UCompanionWorldSubsystem>())
+            {
+                CompanionWorld->RegisterCompanion(this);
+            }
+            ApplyAILOD();
+            
             // Log initialization
             UE_LOG(LogTemp, Log, TEXT("AICompanionController initialized behavior tree for %s"), *GetNameSafe(InPawn));
             DebugBlackboardValues();
@@ -80,15 +135,33 @@ void AAICompanionController::OnPossess(APawn* InPawn)
 
 void AAICompanionController::OnUnPossess()
 {
-    // Cleanup behavior tree and timers
+    // Never leave the pawn frozen
+    WakeFromHibernation();
+    GetWorldTimerManager().ClearTimer(HibernateTimerHandle);
+    
+    // Buffered stimuli and perception memory belong to the pawn being released
+    PendingStimuli.Reset();
+    bHasPendingThreat = false;
+    StimulusHistory.Reset();
+    ThreatTracker.Reset();
+    
+    if (APawn* MyPawn = GetPawn())
+    {
+        MyPawn->OnTakeAnyDamage.RemoveDynamic(this, &AAICompanionController::OnPawnTakeAnyDamage);
+    }
+    
+    // Land anything queued this frame before the tree stops
+    FlushBlackboardWrites();
+    
+    // Cleanup behavior tree and batched updates
     if (BehaviorTreeComponent)
     {
         BehaviorTreeComponent->StopTree();
     }
     
-    if (GetWorld())
+    if (UCompanionWorldSubsystem* CompanionWorld = GetWorld() ? GetWorld()->GetSubsystem<UCompanionWorldSubsystem>() : nullptr)
     {
-        GetWorld()->GetTimerManager().ClearTimer(BlackboardUpdateTimerHandle);
+        CompanionWorld->UnregisterCompanion(this);
     }
     
     Super::OnUnPossess();
@@ -97,97 +170,231 @@ void AAICompanionController::OnUnPossess()
 // Setup AI perception system with sight and hearing
 void AAICompanionController::SetupPerceptionSystem()
 {
-    // Create perception component
+    // Create perception component; sight and hearing configs come from the shared perception profile
+    // in UpdatePerceptionSettings, so no per-controller config subobjects are created here
     SetPerceptionComponent(*CreateDefaultSubobject<UAIPerceptionComponent>(TEXT("Perception Component")));
     
-    // Setup sight configuration
-    SightConfig = CreateDefaultSubobject<UAISenseConfig_Sight>(TEXT("Sight Config"));
-    if (SightConfig)
-    {
-        SightConfig->SightRadius = 1000.f;
-        SightConfig->LoseSightRadius = SightConfig->SightRadius + 50.f;
-        SightConfig->PeripheralVisionAngleDegrees = 90.f;
-        SightConfig->SetMaxAge(5.f);
-        SightConfig->AutoSuccessRangeFromLastSeenLocation = 900.f;
-        SightConfig->DetectionByAffiliation.bDetectEnemies = true;
-        SightConfig->DetectionByAffiliation.bDetectFriendlies = true;
-        SightConfig->DetectionByAffiliation.bDetectNeutrals = true;
-        
-        GetPerceptionComponent()->ConfigureSense(*SightConfig);
+    // Set dominant sense and bind perception update function
+    GetPerceptionComponent()->SetDominantSense(UAISense_Sight::StaticClass());
+    GetPerceptionComponent()->OnTargetPerceptionUpdated.AddDynamic(this, &AAICompanionController::OnTargetPerceptionUpdated);
+}
+
+const UCompanionPerceptionProfile& AAICompanionController::GetPerceptionProfile() const
+{
+    return PerceptionProfile ? *PerceptionProfile : *GetDefault<UCompanionPerceptionProfile>();
+}
+
+// Queue perception updates; they are handled in one batch per frame
+void AAICompanionController::OnTargetPerceptionUpdated(AActor* Actor, FAIStimulus const Stimulus)
+{
+    if (!BlackboardComponent || !Actor)
+    {
+        return;
     }
     
-    // Setup hearing configuration
-    HearingConfig = CreateDefaultSubobject<UAISenseConfig_Hearing>(TEXT("Hearing Config"));
-    if (HearingConfig)
+    // Anything newly sensed is worth waking up for, except seeing the owner or fellow companions
+    if (bHibernating && Stimulus.WasSuccessfullySensed() && !IsFamiliarSight(Actor, Stimulus))
     {
-        HearingConfig->HearingRange = 1500.f;
-        // Fixed: Removed deprecated LoSHearingRange property, using HearingRange instead
-        // HearingConfig->LoSHearingRange = 1500.f; // This line is deprecated
-        HearingConfig->SetMaxAge(7.f);
-        HearingConfig->DetectionByAffiliation.bDetectEnemies = true;
-        HearingConfig->DetectionByAffiliation.bDetectFriendlies = true;
-        HearingConfig->DetectionByAffiliation.bDetectNeutrals = true;
-        
-        GetPerceptionComponent()->ConfigureSense(*HearingConfig);
+        WakeFromHibernation();
     }
     
-    // Set dominant sense and bind perception update function
-    GetPerceptionComponent()->SetDominantSense(SightConfig->GetSenseImplementation());
-    GetPerceptionComponent()->OnTargetPerceptionUpdated.AddDynamic(this, &AAICompanionController::OnTargetPerceptionUpdated);
+    // History keeps every event, including ones the batch below coalesces away
+    StimulusHistory.Record(Actor, Stimulus, GetWorld()->GetTimeSeconds());
+    
+    // Only the latest stimulus per actor matters by the time the batch runs
+    FPendingStimulus& Pending = PendingStimuli.FindOrAdd(Actor);
+    Pending.Actor = Actor;
+    Pending.Stimulus = Stimulus;
+    
+    const FStimulusHandler* Handler = GetStimulusHandlers().Find(Stimulus.Tag);
+    bHasPendingThreat |= Handler && *Handler == &AAICompanionController::HandleThreatStimulus;
 }
 
-// Handle perception updates
-void AAICompanionController::OnTargetPerceptionUpdated(AActor* Actor, FAIStimulus const Stimulus)
+// Handle every stimulus queued since the last batch
+void AAICompanionController::ProcessPendingStimuli()
 {
-    if (!BlackboardComponent)
+    // Between batches stimuli keep coalescing per actor, which is what the adaptive interval throttles.
+    // Threats skip the wait: a slower interval must not delay the reaction to an enemy.
+    const double Now = GetWorld()->GetTimeSeconds();
+    if (PendingStimuli.Num() == 0)
     {
         return;
     }
-    
-    // If the detected actor is our owner player
-    if (Actor == OwnerPlayer)
+    const bool bBatchDue = Now >= NextStimulusBatchTime;
+    if (!bBatchDue && !bHasPendingThreat)
     {
-        BlackboardComponent->SetValueAsBool("IsOwnerSeen", Stimulus.WasSuccessfullySensed());
         return;
     }
+    if (bBatchDue)
+    {
+        NextStimulusBatchTime = Now + PerceptionSettings.SenseUpdateInterval;
+    }
+    bHasPendingThreat = false;
+    
+    // Resolved once per batch instead of once per stimulus
+    const ACharacter* LocalPlayer = UGameplayStatics::GetPlayerCharacter(GetWorld(), 0);
+    const TMap<FName, FStimulusHandler>& Handlers = GetStimulusHandlers();
+    const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
     
-    // If the detected actor is a player but not our owner (for multiplayer)
-    if (Actor->IsA(ACharacter::StaticClass()) && UGameplayStatics::GetPlayerCharacter(GetWorld(), 0) == Actor)
+    for (auto It = PendingStimuli.CreateIterator(); It; ++It)
     {
-        BlackboardComponent->SetValueAsBool("IsPlayerSeen", Stimulus.WasSuccessfullySensed());
+        AActor* Actor = It.Value().Actor.Get();
+        const FAIStimulus Stimulus = It.Value().Stimulus;
+        const FStimulusHandler* Handler = Handlers.Find(Stimulus.Tag);
         
-        // Store last known player location
-        if (Stimulus.WasSuccessfullySensed())
+        // Between batches only threats are handled; everything else waits for the batch
+        if (Actor && !bBatchDue && !(Handler && *Handler == &AAICompanionController::HandleThreatStimulus))
         {
-            BlackboardComponent->SetValueAsVector("LastKnownPlayerLocation", Stimulus.StimulusLocation);
+            continue;
+        }
+        It.RemoveCurrent();
+        if (!Actor)
+        {
+            continue;
         }
-    }
-    
-    // Handle threat detection
-    if (Stimulus.Tag == "Threat" || Stimulus.Tag == "Enemy")
-    {
-        BlackboardComponent->SetValueAsBool("IsThreatDetected", Stimulus.WasSuccessfullySensed());
-        BlackboardComponent->SetValueAsObject("ThreatActor", Actor);
         
-        if (Stimulus.WasSuccessfullySensed())
+        // If the detected actor is our owner player
+        if (Actor == OwnerPlayer)
         {
-            BlackboardComponent->SetValueAsVector("ThreatLocation", Stimulus.StimulusLocation);
+            Keys.IsOwnerSeen.Set(BlackboardWrites, Stimulus.WasSuccessfullySensed());
+            continue;
+        }
+        
+        // If the detected actor is a player but not our owner (for multiplayer)
+        if (Actor == LocalPlayer)
+        {
+            Keys.IsPlayerSeen.Set(BlackboardWrites, Stimulus.WasSuccessfullySensed());
+            
+            // Store last known player location
+            if (Stimulus.WasSuccessfullySensed())
+            {
+                Keys.LastKnownPlayerLocation.Set(BlackboardWrites, Stimulus.StimulusLocation);
+            }
         }
-    }
-    
-    // Handle resource detection for survival gameplay
-    if (Stimulus.Tag == "Resource")
-    {
-        BlackboardComponent->SetValueAsBool("IsResourceDetected", Stimulus.WasSuccessfullySensed());
-        BlackboardComponent->SetValueAsObject("ResourceActor", Actor);
         
-        if (Stimulus.WasSuccessfullySensed())
+        // One lookup routes the stimulus to its tag handler
+        if (Handler)
         {
-            BlackboardComponent->SetValueAsVector("ResourceLocation", Stimulus.StimulusLocation);
+            (this->**Handler)(Actor, Stimulus);
         }
     }
 }
 
+const TMap<FName, AAICompanionController::FStimulusHandler>& AAICompanionController::GetStimulusHandlers()
+{
+    static const TMap<FName, FStimulusHandler> Handlers = []()
+    {
+        TMap<FName, FStimulusHandler> Map;
+        Map.Add(CompanionTags::Stimulus_Threat.GetTag().GetTagName(),   &AAICompanionController::HandleThreatStimulus);
+        Map.Add(CompanionTags::Stimulus_Resource.GetTag().GetTagName(), &AAICompanionController::HandleResourceStimulus);
+        
+        // Legacy tags still used by existing noise events and stimuli sources
+        Map.Add(TEXT("Threat"),   &AAICompanionController::HandleThreatStimulus);
+        Map.Add(TEXT("Enemy"),    &AAICompanionController::HandleThreatStimulus);
+        Map.Add(TEXT("Resource"), &AAICompanionController::HandleResourceStimulus);
+        return Map;
+    }();
+    return Handlers;
+}
+
+namespace
+{
+    /** Whether an AI-driven threat is currently focused on Target */
+    bool IsFocusedOn(const AActor* Threat, const AActor* Target)
+    {
+        const APawn* ThreatPawn = Cast<APawn>(Threat);
+        const AAIController* ThreatController = ThreatPawn ? Cast<AAIController>(ThreatPawn->GetController()) : nullptr;
+        return Target && ThreatController && ThreatController->GetFocusActor() == Target;
+    }
+}
+
+// Handle threat detection
+void AAICompanionController::HandleThreatStimulus(AActor* Actor, const FAIStimulus& Stimulus)
+{
+    // Lost stimuli are left to the tracker, which forgets threats that stay unseen
+    if (!Stimulus.WasSuccessfullySensed())
+    {
+        return;
+    }
+    
+    ReportThreat(Actor, Stimulus.StimulusLocation);
+    
+    // Share the threat with every companion's awareness query
+    if (UCompanionWorldSubsystem* Subsystem = GetWorld()->GetSubsystem<UCompanionWorldSubsystem>())
+    {
+        Subsystem->RegisterThreat(Actor);
+    }
+}
+
+void AAICompanionController::ReportThreat(AActor* Threat, const FVector& Location)
+{
+    const APawn* MyPawn = GetPawn();
+    if (!Threat || !MyPawn)
+    {
+        return;
+    }
+    
+    const float Distance = FVector::Dist(MyPawn->GetActorLocation(), Location);
+    if (ThreatTracker.ReportSighting(Threat, Location, Distance, IsFocusedOn(Threat, MyPawn), IsFocusedOn(Threat, OwnerPlayer), GetWorld()->GetTimeSeconds()))
+    {
+        WriteThreatTarget();
+    }
+}
+
+bool AAICompanionController::IsActorPerceived(const AActor* Actor) const
+{
+    const UAIPerceptionComponent* Perception = GetPerceptionComponent();
+    const FActorPerceptionInfo* Info = Perception && Actor ? Perception->GetActorInfo(*Actor) : nullptr;
+    return Info && Info->HasAnyCurrentStimulus();
+}
+
+void AAICompanionController::WriteThreatTarget()
+{
+    const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
+    const FCompanionTrackedThreat* Target = ThreatTracker.GetTargetEntry();
+    
+    Keys.IsThreatDetected.Set(BlackboardWrites, Target != nullptr);
+    Keys.ThreatActor.Set(BlackboardWrites, Target ? Target->Actor.Get() : nullptr);
+    if (Target)
+    {
+        Keys.ThreatLocation.Set(BlackboardWrites, Target->Location);
+    }
+}
+
+void AAICompanionController::OnPawnTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+{
+    AActor* Attacker = InstigatedBy && InstigatedBy->GetPawn() ? InstigatedBy->GetPawn() : DamageCauser;
+    const APawn* MyPawn = GetPawn();
+    if (!Attacker || !MyPawn || Attacker == MyPawn || Attacker == OwnerPlayer)
+    {
+        return;
+    }
+    
+    const FVector Location = Attacker->GetActorLocation();
+    if (ThreatTracker.ReportDamage(Attacker, Damage, Location, FVector::Dist(MyPawn->GetActorLocation(), Location), GetWorld()->GetTimeSeconds()))
+    {
+        WriteThreatTarget();
+    }
+    
+    if (UCompanionWorldSubsystem* Subsystem = GetWorld()->GetSubsystem<UCompanionWorldSubsystem>())
+    {
+        Subsystem->RegisterThreat(Attacker);
+    }
+}
+
+// Handle resource detection for survival gameplay
+void AAICompanionController::HandleResourceStimulus(AActor* Actor, const FAIStimulus& Stimulus)
+{
+    const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
+    Keys.IsResourceDetected.Set(BlackboardWrites, Stimulus.WasSuccessfullySensed());
+    Keys.ResourceActor.Set(BlackboardWrites, Actor);
+    
+    if (Stimulus.WasSuccessfullySensed())
+    {
+        Keys.ResourceLocation.Set(BlackboardWrites, Stimulus.StimulusLocation);
+    }
+}
+
 // Setup companion-specific blackboard values
 void AAICompanionController::SetupCompanionBlackboardValues()
 {
@@ -196,41 +403,25 @@ void AAICompanionController::SetupCompanionBlackboardValues()
         return;
     }
     
+    // Scores, states and survival values come from a per-asset baked block copied in one go,
+    // without per-key observer notifications
+    const UCompanionBlackboardDefaults* Defaults = BlackboardDefaults ? BlackboardDefaults.Get() : GetDefault<UCompanionBlackboardDefaults>();
+    if (const UBlackboardData* BlackboardAsset = BlackboardComponent->GetBlackboardAsset())
+    {
+        Defaults->GetBakedValues(*BlackboardAsset).Restore(*BlackboardComponent);
+    }
+    
+    const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
+    
     // Set core references
-    BlackboardComponent->SetValueAsObject("SelfActor", GetPawn());
-    BlackboardComponent->SetValueAsObject("CompanionRef", GetPawn());
+    Keys.SelfActor.Set(BlackboardComponent, GetPawn());
+    Keys.CompanionRef.Set(BlackboardComponent, GetPawn());
     
     // Set the owner player reference if available
     SetOwnerPlayer(UGameplayStatics::GetPlayerCharacter(GetWorld(), 0));
     
     // Set home location to current position
-    BlackboardComponent->SetValueAsVector("HomeLocation", GetPawn()->GetActorLocation());
-    
-    // Initialize scores with survival focus
-    BlackboardComponent->SetValueAsFloat("IdleScore", 0.2f);
-    BlackboardComponent->SetValueAsFloat("FollowScore", 0.5f);
-    BlackboardComponent->SetValueAsFloat("PatrolScore", 0.3f);
-    BlackboardComponent->SetValueAsFloat("GatherScore", 0.8f); // Higher priority for survival game
-    BlackboardComponent->SetValueAsFloat("CombatScore", 0.9f); // Higher for combat in survival game
-    
-    // Initialize states
-    BlackboardComponent->SetValueAsBool("IsTaskActive", false);
-    BlackboardComponent->SetValueAsBool("IsFollowing", false);
-    BlackboardComponent->SetValueAsBool("IsPatrolling", false);
-    BlackboardComponent->SetValueAsBool("IsGathering", false);
-    BlackboardComponent->SetValueAsBool("HasValidTarget", false);
-    BlackboardComponent->SetValueAsBool("IsOwnerInDanger", false);
-    BlackboardComponent->SetValueAsBool("IsSelfInDanger", false);
-    BlackboardComponent->SetValueAsBool("IsResourceDetected", false);
-    BlackboardComponent->SetValueAsBool("IsThreatDetected", false);
-    BlackboardComponent->SetValueAsEnum("CurrentTaskType", 0); // None
-    
-    // Survival-specific values
-    BlackboardComponent->SetValueAsInt("InventorySpace", 10);
-    BlackboardComponent->SetValueAsInt("ResourceAmount", 0);
-    BlackboardComponent->SetValueAsFloat("OwnerProximity", 0.0f);
-    BlackboardComponent->SetValueAsFloat("CurrentStamina", 100.0f);
-    BlackboardComponent->SetValueAsFloat("MaxStamina", 100.0f);
+    Keys.HomeLocation.Set(BlackboardComponent, GetPawn()->GetActorLocation());
 }
 
 // Set the owner player for this companion
@@ -245,8 +436,9 @@ void AAICompanionController::SetOwnerPlayer(ACharacter* NewOwnerPlayer)
     // Update blackboard if available
     if (BlackboardComponent && OwnerPlayer)
     {
-        BlackboardComponent->SetValueAsObject("PlayerRef", OwnerPlayer);
-        BlackboardComponent->SetValueAsVector("OwnerLocation", OwnerPlayer->GetActorLocation());
+        const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
+        Keys.PlayerRef.Set(BlackboardComponent, OwnerPlayer);
+        Keys.OwnerLocation.Set(BlackboardComponent, OwnerPlayer->GetActorLocation());
         
         UE_LOG(LogTemp, Log, TEXT("AICompanionController: Owner player set to %s"), *GetNameSafe(OwnerPlayer));
     }
@@ -258,7 +450,7 @@ ACharacter* AAICompanionController::GetOwnerPlayer() const
     return OwnerPlayer;
 }
 
-// Update blackboard values periodically for performance
+// Immediate single-companion refresh (the batched path lives in UCompanionWorldSubsystem)
 void AAICompanionController::UpdateBlackboardValues()
 {
     if (!BlackboardComponent || !GetPawn() || !OwnerPlayer)
@@ -266,24 +458,63 @@ void AAICompanionController::UpdateBlackboardValues()
         return;
     }
     
-    // Update owner location and distance
-    FVector OwnerLocation = OwnerPlayer->GetActorLocation();
-    BlackboardComponent->SetValueAsVector("OwnerLocation", OwnerLocation);
+    const FVector CompanionLocation = GetPawn()->GetActorLocation();
+    const FVector OwnerLocation = OwnerPlayer->GetActorLocation();
+    const float OwnerDistance = FVector::Distance(CompanionLocation, OwnerLocation);
+    const float OwnerProximity = FMath::Clamp(1.0f - (OwnerDistance / UCompanionWorldSubsystem::MaxProximityRange), 0.0f, 1.0f);
     
-    // Calculate distance to owner
-    float OwnerDistance = FVector::Distance(GetPawn()->GetActorLocation(), OwnerLocation);
-    BlackboardComponent->SetValueAsFloat("OwnerDistance", OwnerDistance);
+    ApplyOwnerProximity(CompanionLocation, OwnerLocation, OwnerDistance, OwnerProximity, true);
+}
+
+// Write the owner/companion distance values for this companion
+void AAICompanionController::ApplyOwnerProximity(const FVector& CompanionLocation, const FVector& OwnerLocation, float OwnerDistance, float OwnerProximity, bool bHasOwner)
+{
+    if (!BlackboardComponent)
+    {
+        return;
+    }
+    
+    const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
     
-    // Calculate normalized proximity (1.0 = very close, 0.0 = far away)
-    float ProximityValue = FMath::Clamp(1.0f - (OwnerDistance / 2000.0f), 0.0f, 1.0f);
-    BlackboardComponent->SetValueAsFloat("OwnerProximity", ProximityValue);
+    Keys.CompanionLocation.Update(*BlackboardComponent, BlackboardWrites, CompanionLocation);
     
-    // Update threat awareness less frequently for performance
-    static int32 UpdateCounter = 0;
-    if (++UpdateCounter % 4 == 0)
+    if (!bHasOwner)
     {
-        UpdateThreatAwareness();
-        UpdateSocialAwareness();
+        return;
+    }
+    
+    // Change-detecting writes: a companion standing still does not wake blackboard observers
+    // Owner-relative values (proximity: 1.0 = very close, 0.0 = far away)
+    Keys.OwnerLocation.Update(*BlackboardComponent, BlackboardWrites, OwnerLocation);
+    Keys.OwnerDistance.Update(*BlackboardComponent, BlackboardWrites, OwnerDistance);
+    Keys.OwnerProximity.Update(*BlackboardComponent, BlackboardWrites, OwnerProximity);
+    
+    // Companion-relative values (proximity inverted: 0.0 = very close, 1.0 = far away)
+    Keys.CompanionDistance.Update(*BlackboardComponent, BlackboardWrites, OwnerDistance);
+    Keys.CompanionProximity.Update(*BlackboardComponent, BlackboardWrites, 1.0f - OwnerProximity);
+    Keys.LastKnownPlayerLocation.Update(*BlackboardComponent, BlackboardWrites, OwnerLocation);
+}
+
+// Expensive awareness work, scheduled per companion by UCompanionWorldSubsystem
+void AAICompanionController::RunHeavyUpdate()
+{
+    UpdateThreatAwareness();
+    UpdateSocialAwareness();
+    
+    // Task and crowding may have changed since the last pass
+    UpdatePerceptionSettings();
+}
+
+// Apply this frame's queued blackboard writes in one pass
+void AAICompanionController::FlushBlackboardWrites()
+{
+    if (BlackboardComponent)
+    {
+        BlackboardWrites.Flush(*BlackboardComponent);
+    }
+    else
+    {
+        BlackboardWrites.Reset();
     }
 }
 
@@ -291,6 +522,7 @@ void AAICompanionController::UpdateBlackboardValues()
 void AAICompanionController::ForceUpdateBlackboardValues()
 {
     UpdateBlackboardValues();
+    FlushBlackboardWrites();
     UpdateThreatAwareness();
     UpdateSocialAwareness();
     UpdatePerceptionSettings();
@@ -306,25 +538,35 @@ void AAICompanionController::DebugBlackboardValues()
         return;
     }
     
+    const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
+    
     // Log all important values
     UE_LOG(LogTemp, Warning, TEXT("---- Blackboard Debug Values ----"));
-    UE_LOG(LogTemp, Warning, TEXT("CurrentTaskType: %d"), BlackboardComponent->GetValueAsEnum("CurrentTaskType"));
-    UE_LOG(LogTemp, Warning, TEXT("IsTaskActive: %s"), BlackboardComponent->GetValueAsBool("IsTaskActive") ? TEXT("true") : TEXT("false"));
-    UE_LOG(LogTemp, Warning, TEXT("IsFollowing: %s"), BlackboardComponent->GetValueAsBool("IsFollowing") ? TEXT("true") : TEXT("false"));
-    UE_LOG(LogTemp, Warning, TEXT("IsPatrolling: %s"), BlackboardComponent->GetValueAsBool("IsPatrolling") ? TEXT("true") : TEXT("false"));
-    UE_LOG(LogTemp, Warning, TEXT("IsGathering: %s"), BlackboardComponent->GetValueAsBool("IsGathering") ? TEXT("true") : TEXT("false"));
+    UE_LOG(LogTemp, Warning, TEXT("CurrentTaskType: %d"), Keys.CurrentTaskType.Get(BlackboardComponent));
+    UE_LOG(LogTemp, Warning, TEXT("IsTaskActive: %s"), Keys.IsTaskActive.Get(BlackboardComponent) ? TEXT("true") : TEXT("false"));
+    UE_LOG(LogTemp, Warning, TEXT("IsFollowing: %s"), Keys.IsFollowing.Get(BlackboardComponent) ? TEXT("true") : TEXT("false"));
+    UE_LOG(LogTemp, Warning, TEXT("IsPatrolling: %s"), Keys.IsPatrolling.Get(BlackboardComponent) ? TEXT("true") : TEXT("false"));
+    UE_LOG(LogTemp, Warning, TEXT("IsGathering: %s"), Keys.IsGathering.Get(BlackboardComponent) ? TEXT("true") : TEXT("false"));
     
     // Log player reference
-    AActor* Player = Cast<AActor>(BlackboardComponent->GetValueAsObject("PlayerRef"));
+    AActor* Player = Cast<AActor>(Keys.PlayerRef.Get(BlackboardComponent));
     UE_LOG(LogTemp, Warning, TEXT("PlayerRef: %s"), Player ? *Player->GetName() : TEXT("nullptr"));
     
     // Log location
-    FVector PlayerLoc = BlackboardComponent->GetValueAsVector("LastKnownPlayerLocation");
+    FVector PlayerLoc = Keys.LastKnownPlayerLocation.Get(BlackboardComponent);
     UE_LOG(LogTemp, Warning, TEXT("PlayerLocation: %s"), *PlayerLoc.ToString());
     
     // Log distance values
-    UE_LOG(LogTemp, Warning, TEXT("OwnerDistance: %.2f"), BlackboardComponent->GetValueAsFloat("OwnerDistance"));
-    UE_LOG(LogTemp, Warning, TEXT("OwnerProximity: %.2f"), BlackboardComponent->GetValueAsFloat("OwnerProximity"));
+    UE_LOG(LogTemp, Warning, TEXT("OwnerDistance: %.2f"), Keys.OwnerDistance.Get(BlackboardComponent));
+    UE_LOG(LogTemp, Warning, TEXT("OwnerProximity: %.2f"), Keys.OwnerProximity.Get(BlackboardComponent));
+    
+    // Log applied perception settings
+    UE_LOG(LogTemp, Warning, TEXT("Perception: Sight=%.0f (%.0f deg), Hearing=%.0f, Interval=%.2fs, Enabled=%s"),
+        PerceptionSettings.SightRadius, PerceptionSettings.PeripheralVisionAngleDegrees, PerceptionSettings.HearingRange,
+        PerceptionSettings.SenseUpdateInterval, PerceptionSettings.bSensesEnabled ? TEXT("true") : TEXT("false"));
+    
+    // Log how many proximity writes were skipped as unchanged
+    Keys.LogWriteStats();
 }
 
 // Log companion status with context
@@ -335,10 +577,12 @@ void AAICompanionController::LogCompanionStatus(const FString& Context)
         return;
     }
     
+    const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
+    
     const FString PawnName = GetNameSafe(GetPawn());
-    const int32 TaskType = BlackboardComponent->GetValueAsEnum("CurrentTaskType");
-    const bool bIsActive = BlackboardComponent->GetValueAsBool("IsTaskActive");
-    const bool bIsFollowing = BlackboardComponent->GetValueAsBool("IsFollowing");
+    const int32 TaskType = Keys.CurrentTaskType.Get(BlackboardComponent);
+    const bool bIsActive = Keys.IsTaskActive.Get(BlackboardComponent);
+    const bool bIsFollowing = Keys.IsFollowing.Get(BlackboardComponent);
     
     UE_LOG(LogTemp, Log, TEXT("[%s] - %s: Task=%d, Active=%s, Following=%s"),
         *Context,
@@ -350,7 +594,7 @@ void AAICompanionController::LogCompanionStatus(const FString& Context)
     // Log location and debug visuals
     if (bIsFollowing)
     {
-        const FVector OwnerLoc = BlackboardComponent->GetValueAsVector("OwnerLocation");
+        const FVector OwnerLoc = Keys.OwnerLocation.Get(BlackboardComponent);
         const FVector MyLoc = GetPawn()->GetActorLocation();
         const float Distance = FVector::Dist(MyLoc, OwnerLoc);
         
@@ -371,8 +615,42 @@ void AAICompanionController::UpdateThreatAwareness()
         return;
     }
     
-    // This would scan for threats in the environment
-    // Implementation depends on your game's threat system
+    UCompanionWorldSubsystem* Subsystem = GetWorld()->GetSubsystem<UCompanionWorldSubsystem>();
+    if (!Subsystem)
+    {
+        return;
+    }
+    
+    // Only the grid cells around the companion are visited, however many threats the world holds
+    const FCompanionThreatGrid& Threats = Subsystem->GetThreatGrid();
+    Threats.QueryNearest(GetPawn()->GetActorLocation(), ThreatAwarenessRadius, MaxTrackedThreats, RankedThreats);
+    
+    // Grid hits are only candidates: the tracker is refreshed just for threats we actually perceive,
+    // which also keeps them alive in the shared grid. The blackboard target only moves when the tracker switches.
+    for (const FCompanionThreatInfo& Threat : RankedThreats)
+    {
+        AActor* Actor = Threat.Actor.Get();
+        if (IsActorPerceived(Actor))
+        {
+            ReportThreat(Actor, Threat.Location);
+            Subsystem->RegisterThreat(Actor);
+        }
+    }
+    
+    const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
+    if (ThreatTracker.Refresh(GetWorld()->GetTimeSeconds()))
+    {
+        WriteThreatTarget();
+    }
+    else if (const FCompanionTrackedThreat* Target = ThreatTracker.GetTargetEntry())
+    {
+        Keys.ThreatLocation.Update(*BlackboardComponent, BlackboardWrites, Target->Location);
+    }
+    
+    Keys.IsSelfInDanger.Update(*BlackboardComponent, BlackboardWrites, RankedThreats.Num() > 0 && RankedThreats[0].Distance <= DangerRadius);
+    
+    const ACharacter* Owner = GetOwnerPlayer();
+    Keys.IsOwnerInDanger.Update(*BlackboardComponent, BlackboardWrites, Owner && Threats.AnyWithin(Owner->GetActorLocation(), DangerRadius));
 }
 
 // Update companion's social awareness for multiplayer
@@ -383,31 +661,352 @@ void AAICompanionController::UpdateSocialAwareness()
         return;
     }
     
-    // This would detect and respond to other players and NPCs
-    // Implemention depends on your game's social systems
+    const UCompanionWorldSubsystem* Subsystem = GetWorld()->GetSubsystem<UCompanionWorldSubsystem>();
+    if (!Subsystem)
+    {
+        return;
+    }
+    
+    // Broad-phase query against the shared pawn index instead of scanning every pawn
+    Subsystem->GetNeighbourIndex().Summarise(GetPawn()->GetActorLocation(), SocialAwarenessRadius, GetPawn(), NeighbourSummary);
+    
+    const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
+    Keys.NearbyPlayerCount.Update(*BlackboardComponent, BlackboardWrites, NeighbourSummary.NumPlayers);
+    Keys.NearbyCompanionCount.Update(*BlackboardComponent, BlackboardWrites, NeighbourSummary.NumCompanions);
+    Keys.NearbyNPCCount.Update(*BlackboardComponent, BlackboardWrites, NeighbourSummary.NumNPCs);
+    Keys.NearestNeighbour.Update(*BlackboardComponent, BlackboardWrites, NeighbourSummary.Nearest.Get());
 }
 
 // Update perception settings based on environment
 void AAICompanionController::UpdatePerceptionSettings_Implementation()
 {
-    // Adjust perception based on environment
-    // e.g., reduce sight in dark areas, increase hearing in quiet areas
+    UAIPerceptionComponent* Perception = GetPerceptionComponent();
+    if (!Perception)
+    {
+        return;
+    }
+    
+    const UCompanionPerceptionProfile& Profile = GetPerceptionProfile();
+    const float BaseSightRadius = PerceptionOverrides.bOverrideSightRadius ? PerceptionOverrides.SightRadius : Profile.SightRadius;
+    const float BaseHearingRange = PerceptionOverrides.bOverrideHearingRange ? PerceptionOverrides.HearingRange : Profile.HearingRange;
+    
+    // Start from the AI LOD bucket
+    const FCompanionAILODSettings& LOD = GetAILODSettings();
+    float RadiusScale = LOD.PerceptionRadiusScale;
+    float Interval = Profile.SenseUpdateInterval / FMath::Max(LOD.PerceptionRadiusScale, 0.25f);
+    float PeripheralAngle = PerceptionOverrides.bOverridePeripheralVisionAngle ? PerceptionOverrides.PeripheralVisionAngle : Profile.PeripheralVisionAngle;
+    
+    // Combat wants full fidelity; an idle companion can afford to notice things late
+    const ECompanionTask Task = static_cast<ECompanionTask>(GetBlackboardKeys().CurrentTaskType.Get(BlackboardComponent));
+    if (Task == ECompanionTask::Combat)
+    {
+        RadiusScale *= Profile.CombatPerceptionScale;
+        PeripheralAngle = FMath::Max(PeripheralAngle, Profile.CombatPeripheralVisionAngle);
+        Interval *= 0.5f;
+    }
+    else if (Task == ECompanionTask::None || Task == ECompanionTask::Idle)
+    {
+        RadiusScale *= Profile.IdlePerceptionScale;
+        Interval *= 2.f;
+    }
+    
+    // Every sense update costs more with many actors around, and a smaller radius still sees plenty
+    if (NeighbourSummary.Total() >= Profile.CrowdedNeighbourCount)
+    {
+        RadiusScale *= Profile.CrowdedPerceptionScale;
+        Interval *= 2.f;
+    }
+    
+    // Pick the shared configs closest to the wanted values
+    UAISenseConfig_Sight* NewSightConfig = Profile.GetSightConfig(BaseSightRadius * RadiusScale * FMath::Max(GetTimeOfDaySightScale(), 0.f), PeripheralAngle);
+    UAISenseConfig_Hearing* NewHearingConfig = Profile.GetHearingConfig(BaseHearingRange * RadiusScale);
+    
+    FCompanionPerceptionSettings NewSettings;
+    NewSettings.SightRadius = NewSightConfig->SightRadius;
+    NewSettings.LoseSightRadius = NewSightConfig->LoseSightRadius;
+    NewSettings.PeripheralVisionAngleDegrees = NewSightConfig->PeripheralVisionAngleDegrees;
+    NewSettings.HearingRange = NewHearingConfig->HearingRange;
+    NewSettings.SenseUpdateInterval = Interval;
+    NewSettings.bSensesEnabled = LOD.bPerceptionEnabled;
+    
+    // ConfigureSense re-registers listeners: skip it when nothing meaningful changed
+    const bool bConfigsChanged = NewSightConfig != SightConfig || NewHearingConfig != HearingConfig;
+    if (!bConfigsChanged && !NewSettings.DiffersFrom(PerceptionSettings))
+    {
+        return;
+    }
+    PerceptionSettings = NewSettings;
+    
+    if (bConfigsChanged)
+    {
+        SightConfig = NewSightConfig;
+        HearingConfig = NewHearingConfig;
+        Perception->ConfigureSense(*SightConfig);
+        Perception->ConfigureSense(*HearingConfig);
+    }
+    Perception->SetSenseEnabled(UAISense_Sight::StaticClass(), NewSettings.bSensesEnabled);
+    Perception->SetSenseEnabled(UAISense_Hearing::StaticClass(), NewSettings.bSensesEnabled);
+}
+
+bool AAICompanionController::CanVirtualise() const
+{
+    const APawn* MyPawn = GetPawn();
+    if (!bAllowVirtualisation || !HasAuthority() || !MyPawn)
+    {
+        return false;
+    }
+    
+    // Respawning gives a replicated pawn a new network identity that clients cannot map back to the old one
+    return GetNetMode() == NM_Standalone || !MyPawn->GetIsReplicated();
 }
 
-// Called every frame
-void AAICompanionController::Tick(float DeltaTime)
+void AAICompanionController::PrepareRehydration(const FCompanionBlackboardSnapshot& Snapshot, ACharacter* InOwnerPlayer, bool bInStayCommanded)
 {
-    Super::Tick(DeltaTime);
+    PendingBlackboardRestore = Snapshot;
+    PendingOwnerRestore = InOwnerPlayer;
+    bStayCommanded = bInStayCommanded;
+}
+
+const FPathFollowingResult* AAICompanionController::FindMoveResult(FAIRequestID RequestID) const
+{
+    return RequestID.IsValid() && RequestID == LastMoveRequestID ? &LastMoveResult : nullptr;
+}
+
+void AAICompanionController::RecordMoveResult(FAIRequestID RequestID, const FPathFollowingResult& Result)
+{
+    LastMoveRequestID = RequestID;
+    LastMoveResult = Result;
+}
+
+const FCompanionAILODSettings& AAICompanionController::GetAILODSettings() const
+{
+    static const FCompanionAILODSettings DefaultSettings;
+    const int32 Index = static_cast<int32>(CurrentAILOD);
+    return AILODSettings.IsValidIndex(Index) ? AILODSettings[Index] : DefaultSettings;
+}
+
+// Pick the AI LOD bucket for a significance distance, with hysteresis when dropping detail
+void AAICompanionController::UpdateAILOD(float SignificanceDistance)
+{
+    if (AILODSettings.Num() == 0)
+    {
+        return;
+    }
+    
+    int32 Desired = AILODSettings.Num() - 1;
+    for (int32 i = 0; i < AILODSettings.Num(); ++i)
+    {
+        if (SignificanceDistance <= AILODSettings[i].MaxDistance)
+        {
+            Desired = i;
+            break;
+        }
+    }
+    
+    const int32 Current = static_cast<int32>(CurrentAILOD);
+    if (Desired == Current)
+    {
+        return;
+    }
+    
+    // Only drop detail once we are clearly outside the current bucket
+    if (Desired > Current && AILODSettings.IsValidIndex(Current)
+        && SignificanceDistance <= AILODSettings[Current].MaxDistance * (1.f + AILODHysteresis))
+    {
+        return;
+    }
+    
+    CurrentAILOD = static_cast<ECompanionAILOD>(FMath::Min(Desired, static_cast<int32>(ECompanionAILOD::Dormant)));
+    ApplyAILOD();
+}
+
+// Push the current LOD bucket to every system it throttles
+void AAICompanionController::ApplyAILOD()
+{
+    const FCompanionAILODSettings& LOD = GetAILODSettings();
+    
+    if (UCompanionWorldSubsystem* CompanionWorld = GetWorld() ? GetWorld()->GetSubsystem<UCompanionWorldSubsystem>() : nullptr)
+    {
+        CompanionWorld->SetCompanionUpdateInterval(this, FMath::Max(BlackboardUpdateInterval, LOD.BlackboardUpdateInterval));
+    }
+    
+    if (APawn* MyPawn = GetPawn())
+    {
+        if (UPawnMovementComponent* MoveComp = MyPawn->GetMovementComponent())
+        {
+            MoveComp->SetComponentTickInterval(LOD.MovementTickInterval);
+        }
+    }
+    
+    RefreshBehaviorTreePause();
+    UpdatePerceptionSettings();
+}
+
+void AAICompanionController::RefreshBehaviorTreePause()
+{
+    if (!BehaviorTreeComponent)
+    {
+        return;
+    }
+    
+    const bool bWantPaused = bHibernating || GetAILODSettings().bPauseBehaviorTree;
+    if (bWantPaused && !BehaviorTreeComponent->IsPaused())
+    {
+        BehaviorTreeComponent->PauseLogic(bHibernating ? TEXT("Hibernation") : TEXT("AI LOD"));
+    }
+    else if (!bWantPaused && BehaviorTreeComponent->IsPaused())
+    {
+        BehaviorTreeComponent->ResumeLogic(TEXT("AI LOD / Hibernation"));
+    }
+}
+
+/* ---------- Hibernation ---------- */
+
+void AAICompanionController::HandleCommand(FName CommandName)
+{
+    bStayCommanded = CommandName == "Stay";
     
-    // Use time accumulator for optimized updates instead of updating every frame
-    UpdateTimeAccumulator += DeltaTime;
+    // Whatever the new command is, the follow branch claims a slot again if it runs
+    if (UCompanionWorldSubsystem* CompanionWorld = GetWorld()->GetSubsystem<UCompanionWorldSubsystem>())
+    {
+        CompanionWorld->ReleaseFollowSlot(this);
+    }
+    WakeFromHibernation();
+    GetWorldTimerManager().ClearTimer(HibernateTimerHandle);
+    ScheduleHibernation();
+}
+
+void AAICompanionController::ScheduleHibernation()
+{
+    // Parked companions hibernate once they have settled
+    if (bStayCommanded && HibernateAfterStaySeconds >= 0.f && !GetWorldTimerManager().IsTimerActive(HibernateTimerHandle))
+    {
+        GetWorldTimerManager().SetTimer(HibernateTimerHandle, this, &AAICompanionController::EnterHibernation,
+            FMath::Max(HibernateAfterStaySeconds, KINDA_SMALL_NUMBER), false);
+    }
+}
+
+void AAICompanionController::UpdateHibernationOwnerDistance(float OwnerDistance)
+{
+    // Only a far-to-near transition wakes: the owner is usually standing right here when it says "Stay"
+    if (OwnerDistance > HibernationWakeDistance * (1.f + HibernationWakeHysteresis))
+    {
+        bOwnerWakeArmed = true;
+    }
+    else if (bOwnerWakeArmed && OwnerDistance <= HibernationWakeDistance)
+    {
+        WakeFromHibernation();
+    }
+}
+
+bool AAICompanionController::IsFamiliarSight(const AActor* Actor, const FAIStimulus& Stimulus) const
+{
+    if (Stimulus.Type != UAISense::GetSenseID<UAISense_Sight>())
+    {
+        return false;
+    }
+    if (Actor == OwnerPlayer)
+    {
+        return true;
+    }
+    const APawn* Pawn = Cast<APawn>(Actor);
+    return Pawn && Cast<AAICompanionController>(Pawn->GetController()) != nullptr;
+}
+
+bool AAICompanionController::IsBusyForHibernation() const
+{
+    if (ThreatTracker.GetTarget())
+    {
+        return true;
+    }
     
-    // Only update intensive operations periodically
-    if (UpdateTimeAccumulator >= BlackboardUpdateInterval)
+    if (BlackboardComponent)
     {
-        UpdateTimeAccumulator = 0.0f;
+        const FCompanionBlackboardKeys& Keys = GetBlackboardKeys();
+        if (Keys.IsOwnerInDanger.Get(BlackboardComponent) || Keys.IsSelfInDanger.Get(BlackboardComponent))
+        {
+            return true;
+        }
         
-        // Updates are now handled by timer for better performance
-        // Critical updates can still be done here if needed
+        // "Stay" parks the companion as Idle; anything else is a task still being carried out
+        const ECompanionTask Task = static_cast<ECompanionTask>(Keys.CurrentTaskType.Get(BlackboardComponent));
+        if (Task != ECompanionTask::None && Task != ECompanionTask::Idle)
+        {
+            return true;
+        }
     }
+    
+    return GetMoveStatus() != EPathFollowingStatus::Idle;
+}
+
+void AAICompanionController::EnterHibernation()
+{
+    APawn* MyPawn = GetPawn();
+    if (bHibernating || !MyPawn)
+    {
+        return;
+    }
+    
+    // Perception only reports changes, so a threat that stays in view would never wake us again: wait until idle
+    if (IsBusyForHibernation())
+    {
+        GetWorldTimerManager().ClearTimer(HibernateTimerHandle);
+        ScheduleHibernation();
+        return;
+    }
+    bHibernating = true;
+    bOwnerWakeArmed = false;
+    
+    if (UCompanionWorldSubsystem* CompanionWorld = GetWorld()->GetSubsystem<UCompanionWorldSubsystem>())
+    {
+        CompanionWorld->ReleaseFollowSlot(this);
+    }
+    
+    StopMovement();
+    if (UPawnMovementComponent* MoveComp = MyPawn->GetMovementComponent())
+    {
+        MoveComp->SetComponentTickEnabled(false);
+    }
+    MyPawn->SetActorTickEnabled(false);
+    SetActorTickEnabled(false);
+    RefreshBehaviorTreePause();
+    
+    UE_LOG(LogTemp, Verbose, TEXT("AICompanionController: %s hibernating"), *GetNameSafe(MyPawn));
+}
+
+void AAICompanionController::WakeFromHibernation()
+{
+    if (!bHibernating)
+    {
+        return;
+    }
+    bHibernating = false;
+    
+    SetActorTickEnabled(true);
+    if (APawn* MyPawn = GetPawn())
+    {
+        MyPawn->SetActorTickEnabled(true);
+        if (UPawnMovementComponent* MoveComp = MyPawn->GetMovementComponent())
+        {
+            MoveComp->SetComponentTickEnabled(true);
+        }
+    }
+    
+    // Catch the blackboard up before the tree resumes, then restore LOD throttling
+    UpdateBlackboardValues();
+    FlushBlackboardWrites();
+    ApplyAILOD();
+    
+    // Still told to stay: try again later; EnterHibernation keeps waiting until whatever woke us has passed
+    ScheduleHibernation();
+    
+    UE_LOG(LogTemp, Verbose, TEXT("AICompanionController: %s woke from hibernation"), *GetNameSafe(GetPawn()));
+}
+
+// Called every frame
+void AAICompanionController::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+    
+    // Periodic blackboard updates are batched by UCompanionWorldSubsystem
 }
\ No newline at end of file
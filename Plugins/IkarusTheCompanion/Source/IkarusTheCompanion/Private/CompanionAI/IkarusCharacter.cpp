@@ -8,19 +8,11 @@
 
 namespace
 {
-    constexpr TCHAR KEY_PlayerRef[]          = TEXT("PlayerRef");
-    constexpr TCHAR KEY_CompanionLocation[]  = TEXT("CompanionLocation");
-    constexpr TCHAR KEY_CompanionDistance[]  = TEXT("CompanionDistance");
-    constexpr TCHAR KEY_CompanionProximity[] = TEXT("CompanionProximity");
-    constexpr TCHAR KEY_LastKnownPlayerLocation[] = TEXT("LastKnownPlayerLocation");
     constexpr TCHAR KEY_CurrentTaskType[]    = TEXT("CurrentTaskType");
     constexpr TCHAR KEY_IsTaskActive[]       = TEXT("IsTaskActive");
     constexpr TCHAR KEY_IsFollowing[]        = TEXT("IsFollowing");
     constexpr TCHAR KEY_IsPatrolling[]       = TEXT("IsPatrolling");
     constexpr TCHAR KEY_IsGathering[]        = TEXT("IsGathering");
-    
-    constexpr float MaxProximityRange = 2000.f;
-    constexpr float BlackboardUpdateInterval = 0.1f; // Update blackboard less frequently
 }
 
 /* ===== ctor ===== */
@@ -72,16 +64,7 @@ void AIkarusCharacter::BeginPlay()
     Super::BeginPlay();
     AIController = Cast<AAICompanionController>(GetController());
     LoadMovementPreset();
-    UpdateBlackboard(); // Initial update
-    
-    // Set timer for blackboard updates instead of every tick
-    GetWorld()->GetTimerManager().SetTimer(
-        BlackboardUpdateTimer,
-        this,
-        &AIkarusCharacter::UpdateBlackboard,
-        BlackboardUpdateInterval,
-        true
-    );
+    // Companion location/distance keys are refreshed by UCompanionWorldSubsystem
 }
 
 void AIkarusCharacter::OnRep_MovementPresetRow()
@@ -96,27 +79,6 @@ void AIkarusCharacter::Tick(float DeltaTime)
     // Removed UpdateBlackboard() call to prevent jittering
 }
 
-/* ===== Blackboard sync ===== */
-void AIkarusCharacter::UpdateBlackboard()
-{
-    if (!AIController) return;
-    if (UBlackboardComponent* BB = AIController->GetBlackboardComponent())
-    {
-        BB->SetValueAsVector(KEY_CompanionLocation, GetActorLocation());
-
-        if (AActor* Player = Cast<AActor>(BB->GetValueAsObject(KEY_PlayerRef)))
-        {
-            const float Dist = FVector::Dist(GetActorLocation(), Player->GetActorLocation());
-            BB->SetValueAsFloat(KEY_CompanionDistance, Dist);
-
-            const float Prox = FMath::Clamp(Dist / MaxProximityRange, 0.f, 1.f);
-            BB->SetValueAsFloat(KEY_CompanionProximity, Prox);
-
-            BB->SetValueAsVector(KEY_LastKnownPlayerLocation, Player->GetActorLocation());
-        }
-    }
-}
-
 /* ===== preset loader ===== */
 void AIkarusCharacter::LoadMovementPreset()
 {
@@ -230,19 +192,24 @@ void AIkarusCharacter::ExecuteCommand(FName CommandName, AActor* Commander)
 if (AIController && AIController->GetBlackboardComponent())
     {
         UBlackboardComponent* BB = AIController->GetBlackboardComponent();
+        const FCompanionBlackboardKeys& Keys = AIController->GetBlackboardKeys();
+        FCompanionBlackboardWriteBuffer& Writes = AIController->GetBlackboardWriteBuffer();
+        
+        // Any command wakes a hibernating companion; "Stay" lets it hibernate again later
+        AIController->HandleCommand(CommandName);
         
         // Reset all task states first
-        BB->SetValueAsBool("IsFollowing", false);
-        BB->SetValueAsBool("IsPatrolling", false);
-        BB->SetValueAsBool("IsGathering", false);
-        BB->SetValueAsBool("IsTaskActive", true);  // Always set this to true for any command
+        Keys.IsFollowing.Set(Writes, false);
+        Keys.IsPatrolling.Set(Writes, false);
+        Keys.IsGathering.Set(Writes, false);
+        Keys.IsTaskActive.Set(Writes, true);  // Always set this to true for any command
         
         if (CommandName == "Follow")
         {
             // Use the exact enum value from ECompanionTask::Follow (which is 2)
-            BB->SetValueAsEnum("CurrentTaskType", static_cast<uint8>(ECompanionTask::Follow));
-            BB->SetValueAsBool("IsFollowing", true);
-            BB->SetValueAsObject("PlayerRef", Commander);
+            Keys.CurrentTaskType.Set(Writes, static_cast<uint8>(ECompanionTask::Follow));
+            Keys.IsFollowing.Set(Writes, true);
+            Keys.PlayerRef.Set(Writes, Commander);
             
             // Debug logging
             UE_LOG(LogTemp, Warning, TEXT("Follow command received - Setting CurrentTaskType to %d (Follow)"), 
@@ -251,13 +218,14 @@ if (AIController && AIController->GetBlackboardComponent())
             // Force debug output
             if (AIController)
             {
+                AIController->FlushBlackboardWrites();
                 AIController->DebugBlackboardValues();
             }
         }
         else if (CommandName == "Stay")
         {
             // Use the exact enum value for Idle
-            BB->SetValueAsEnum("CurrentTaskType", static_cast<uint8>(ECompanionTask::Idle));
+            Keys.CurrentTaskType.Set(Writes, static_cast<uint8>(ECompanionTask::Idle));
             
             // Debug logging
             UE_LOG(LogTemp, Warning, TEXT("Stay command received - Setting CurrentTaskType to %d (Idle)"), 
@@ -265,19 +233,22 @@ if (AIController && AIController->GetBlackboardComponent())
         }
         else if (CommandName == "Patrol")
         {
-            BB->SetValueAsEnum("CurrentTaskType", static_cast<uint8>(ECompanionTask::Patrol));
-            BB->SetValueAsBool("IsPatrolling", true);
+            Keys.CurrentTaskType.Set(Writes, static_cast<uint8>(ECompanionTask::Patrol));
+            Keys.IsPatrolling.Set(Writes, true);
             
             // Debug logging
             UE_LOG(LogTemp, Warning, TEXT("Patrol command received - Setting CurrentTaskType to %d (Patrol)"), 
                 static_cast<uint8>(ECompanionTask::Patrol));
         }
         
+        // Apply the reset and the new task together so the tree re-evaluates once
+        AIController->FlushBlackboardWrites();
+        
         // Always log the final state after setting values
         UE_LOG(LogTemp, Warning, TEXT("Final state: TaskType=%d, IsTaskActive=%s, IsFollowing=%s"),
-            BB->GetValueAsEnum("CurrentTaskType"),
-            BB->GetValueAsBool("IsTaskActive") ? TEXT("true") : TEXT("false"),
-            BB->GetValueAsBool("IsFollowing") ? TEXT("true") : TEXT("false"));
+            Keys.CurrentTaskType.Get(BB),
+            Keys.IsTaskActive.Get(BB) ? TEXT("true") : TEXT("false"),
+            Keys.IsFollowing.Get(BB) ? TEXT("true") : TEXT("false"));
     }
 }
 
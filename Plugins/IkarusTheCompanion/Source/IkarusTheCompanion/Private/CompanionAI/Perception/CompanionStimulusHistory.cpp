@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionAI/Perception/CompanionStimulusHistory.h"
+
+static_assert(FCompanionStimulusHistory::Capacity <= TNumericLimits<int8>::Max(), "Ring slots are stored as int8");
+
+FCompanionStimulusHistory::FCompanionStimulusHistory()
+{
+    Reset();
+}
+
+void FCompanionStimulusHistory::Reset()
+{
+    for (int8& Bucket : Buckets)
+    {
+        Bucket = EmptyBucket;
+    }
+    Head = 0;
+    Num = 0;
+}
+
+uint32 FCompanionStimulusHistory::HashOf(const TObjectKey<AActor>& Actor, FAISenseID Sense)
+{
+    return HashCombineFast(GetTypeHash(Actor), ::GetTypeHash(Sense.Index));
+}
+
+int32 FCompanionStimulusHistory::FindBucket(const TObjectKey<AActor>& Actor, FAISenseID Sense) const
+{
+    for (int32 Bucket = HashOf(Actor, Sense) & (NumBuckets - 1); Buckets[Bucket] != EmptyBucket; Bucket = (Bucket + 1) & (NumBuckets - 1))
+    {
+        const FCompanionStimulusRecord& Record = Records[Buckets[Bucket]];
+        if (Record.Actor == Actor && Record.Sense == Sense)
+        {
+            return Bucket;
+        }
+    }
+    return INDEX_NONE;
+}
+
+void FCompanionStimulusHistory::RemoveBucket(int32 Bucket)
+{
+    // Linear-probing backward shift: no tombstones, so lookups never degrade
+    Buckets[Bucket] = EmptyBucket;
+    for (int32 Next = (Bucket + 1) & (NumBuckets - 1); Buckets[Next] != EmptyBucket; Next = (Next + 1) & (NumBuckets - 1))
+    {
+        const FCompanionStimulusRecord& Record = Records[Buckets[Next]];
+        const int32 Home = HashOf(Record.Actor, Record.Sense) & (NumBuckets - 1);
+
+        // Move the entry back unless its home lies cyclically in (Bucket, Next]
+        const bool bHomeBetween = Bucket <= Next ? (Home > Bucket && Home <= Next) : (Home > Bucket || Home <= Next);
+        if (!bHomeBetween)
+        {
+            Buckets[Bucket] = Buckets[Next];
+            Buckets[Next] = EmptyBucket;
+            Bucket = Next;
+        }
+    }
+}
+
+void FCompanionStimulusHistory::Record(const AActor* Actor, const FAIStimulus& Stimulus, double Time)
+{
+    const TObjectKey<AActor> Key(Actor);
+
+    // Evict the oldest record; drop its index entry only if it is still the newest for its pair
+    if (Num == Capacity)
+    {
+        const FCompanionStimulusRecord& Oldest = Records[Head];
+        const int32 OldBucket = FindBucket(Oldest.Actor, Oldest.Sense);
+        if (OldBucket != INDEX_NONE && Buckets[OldBucket] == Head)
+        {
+            RemoveBucket(OldBucket);
+        }
+    }
+
+    // Look the pair up before overwriting the slot, which may hold one of its older records
+    const int32 ExistingBucket = FindBucket(Key, Stimulus.Type);
+
+    FCompanionStimulusRecord& Record = Records[Head];
+    Record.Actor = Key;
+    Record.Sense = Stimulus.Type;
+    Record.Tag = Stimulus.Tag;
+    Record.Location = Stimulus.StimulusLocation;
+    Record.Time = Time;
+    Record.Strength = Stimulus.Strength;
+    Record.bSensed = Stimulus.WasSuccessfullySensed();
+
+    if (ExistingBucket != INDEX_NONE)
+    {
+        Buckets[ExistingBucket] = static_cast<int8>(Head);
+    }
+    else
+    {
+        int32 Bucket = HashOf(Key, Stimulus.Type) & (NumBuckets - 1);
+        while (Buckets[Bucket] != EmptyBucket)
+        {
+            Bucket = (Bucket + 1) & (NumBuckets - 1);
+        }
+        Buckets[Bucket] = static_cast<int8>(Head);
+    }
+
+    Head = (Head + 1) % Capacity;
+    Num = FMath::Min(Num + 1, Capacity);
+}
+
+const FCompanionStimulusRecord* FCompanionStimulusHistory::FindLatest(const AActor* Actor, FAISenseID Sense) const
+{
+    const int32 Bucket = FindBucket(TObjectKey<AActor>(Actor), Sense);
+    return Bucket != INDEX_NONE ? &Records[Buckets[Bucket]] : nullptr;
+}
+
+bool FCompanionStimulusHistory::IsSensed(const AActor* Actor, FAISenseID Sense, double Now, double MaxAge) const
+{
+    const FCompanionStimulusRecord* Latest = FindLatest(Actor, Sense);
+    return Latest && Latest->bSensed && Now - Latest->Time <= MaxAge;
+}
@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionAI/Perception/CompanionThreatTracker.h"
+
+int32 FCompanionThreatTracker::IndexOf(const AActor* Actor) const
+{
+    return Heap.IndexOfByPredicate([Actor](const FCompanionTrackedThreat& Threat) { return Threat.Actor.Get() == Actor; });
+}
+
+float FCompanionThreatTracker::ScoreOf(const FCompanionTrackedThreat& Threat, double Now) const
+{
+    const float Proximity = 1.f - FMath::Clamp(Threat.Distance / FMath::Max(Scoring.MaxDistance, 1.f), 0.f, 1.f);
+
+    float RecentDamage = 0.f;
+    if (Threat.Damage > 0.f)
+    {
+        const float Age = static_cast<float>(Now - Threat.LastDamageTime);
+        RecentDamage = Threat.Damage * FMath::Exp(-Age / FMath::Max(Scoring.DamageMemorySeconds, KINDA_SMALL_NUMBER));
+    }
+
+    const float Targeting = Threat.bTargetsOwner ? Scoring.TargetingOwnerWeight : Threat.bTargetsSelf ? Scoring.TargetingSelfWeight : 0.f;
+
+    return Scoring.DistanceWeight * Proximity
+        + Scoring.DamageWeight * FMath::Min(RecentDamage / FMath::Max(Scoring.DamageForFullScore, KINDA_SMALL_NUMBER), 1.f)
+        + Targeting;
+}
+
+void FCompanionThreatTracker::Commit(int32 Index, FCompanionTrackedThreat&& Threat, double Now)
+{
+    Threat.Score = ScoreOf(Threat, Now);
+
+    if (Index != INDEX_NONE)
+    {
+        Heap.HeapRemoveAt(Index, HigherScore, EAllowShrinking::No);
+    }
+    else if (Heap.Num() == Capacity)
+    {
+        // Full: the newcomer only gets in by beating the weakest tracked threat
+        int32 Weakest = 0;
+        for (int32 i = 1; i < Heap.Num(); ++i)
+        {
+            if (Heap[i].Score < Heap[Weakest].Score)
+            {
+                Weakest = i;
+            }
+        }
+        if (Threat.Score <= Heap[Weakest].Score)
+        {
+            return;
+        }
+        Heap.HeapRemoveAt(Weakest, HigherScore, EAllowShrinking::No);
+    }
+
+    Heap.HeapPush(MoveTemp(Threat), HigherScore);
+}
+
+bool FCompanionThreatTracker::ReportSighting(AActor* Actor, const FVector& Location, float Distance, bool bTargetsSelf, bool bTargetsOwner, double Now)
+{
+    if (!Actor)
+    {
+        return false;
+    }
+
+    const int32 Index = IndexOf(Actor);
+    FCompanionTrackedThreat Threat = Index != INDEX_NONE ? Heap[Index] : FCompanionTrackedThreat();
+    Threat.Actor = Actor;
+    Threat.Location = Location;
+    Threat.Distance = Distance;
+    Threat.bTargetsSelf = bTargetsSelf;
+    Threat.bTargetsOwner = bTargetsOwner;
+    Threat.LastSensedTime = Now;
+
+    Commit(Index, MoveTemp(Threat), Now);
+    return SelectTarget();
+}
+
+bool FCompanionThreatTracker::ReportDamage(AActor* Actor, float Amount, const FVector& Location, float Distance, double Now)
+{
+    if (!Actor || Amount <= 0.f)
+    {
+        return false;
+    }
+
+    const int32 Index = IndexOf(Actor);
+    FCompanionTrackedThreat Threat = Index != INDEX_NONE ? Heap[Index] : FCompanionTrackedThreat();
+
+    // Fold the decayed old damage into the new total so the memory restarts from now
+    const float Age = static_cast<float>(Now - Threat.LastDamageTime);
+    Threat.Damage = Threat.Damage * FMath::Exp(-Age / FMath::Max(Scoring.DamageMemorySeconds, KINDA_SMALL_NUMBER)) + Amount;
+    Threat.LastDamageTime = Now;
+    Threat.Actor = Actor;
+    Threat.Location = Location;
+    Threat.Distance = Distance;
+    Threat.bTargetsSelf = true;
+    Threat.LastSensedTime = Now;
+
+    Commit(Index, MoveTemp(Threat), Now);
+    return SelectTarget();
+}
+
+bool FCompanionThreatTracker::Refresh(double Now)
+{
+    Heap.RemoveAll([this, Now](const FCompanionTrackedThreat& Threat)
+    {
+        return !Threat.Actor.IsValid() || Now - Threat.LastSensedTime > Scoring.ForgetAfterSeconds;
+    });
+
+    for (FCompanionTrackedThreat& Threat : Heap)
+    {
+        Threat.Score = ScoreOf(Threat, Now);
+    }
+    Heap.Heapify(HigherScore);
+
+    return SelectTarget();
+}
+
+const FCompanionTrackedThreat* FCompanionThreatTracker::GetTargetEntry() const
+{
+    const int32 Index = IndexOf(Target.Get());
+    return Target.IsValid() && Index != INDEX_NONE ? &Heap[Index] : nullptr;
+}
+
+bool FCompanionThreatTracker::SelectTarget()
+{
+    AActor* Best = Heap.Num() > 0 ? Heap.HeapTop().Actor.Get() : nullptr;
+    AActor* Current = Target.Get();
+    if (Best == Current)
+    {
+        // A target that was set but has since died or been forgotten still has to be cleared
+        // so the blackboard drops it
+        if (!Target.IsExplicitlyNull() && !Target.IsValid())
+        {
+            Target.Reset();
+            return true;
+        }
+        return false;
+    }
+
+    // Keep the current target unless the best one beats it by the switch margin
+    if (const FCompanionTrackedThreat* CurrentEntry = GetTargetEntry())
+    {
+        if (Heap.HeapTop().Score <= CurrentEntry->Score * (1.f + Scoring.SwitchMargin))
+        {
+            return false;
+        }
+    }
+
+    Target = Best;
+    return true;
+}
+
+void FCompanionThreatTracker::Reset()
+{
+    Heap.Reset();
+    Target.Reset();
+}
@@ -0,0 +1,114 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionAI/Spatial/CompanionFollowSlots.h"
+#include "GameFramework/Controller.h"
+#include "NavigationSystem.h"
+
+void FCompanionFollowSlotRing::Initialize(int32 NumSlots, float Radius)
+{
+    Slots.Reset();
+    Slots.SetNum(FMath::Max(NumSlots, 1));
+
+    for (int32 i = 0; i < Slots.Num(); ++i)
+    {
+        const float Angle = UE_TWO_PI * i / Slots.Num();
+        Slots[i].Offset = FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * Radius;
+    }
+    bProjected = false;
+}
+
+bool FCompanionFollowSlotRing::NeedsReprojection(const FVector& PlayerLocation, float Threshold) const
+{
+    return !bProjected || FVector::DistSquared(PlayerLocation, Anchor) > FMath::Square(Threshold);
+}
+
+int32 FCompanionFollowSlotRing::Reproject(const UNavigationSystemV1& NavSys, const FVector& PlayerLocation)
+{
+    for (FSlot& Slot : Slots)
+    {
+        FNavLocation Projected;
+        Slot.bValid = NavSys.ProjectPointToNavigation(PlayerLocation + Slot.Offset, Projected);
+        if (Slot.bValid)
+        {
+            Slot.Location = Projected.Location;
+        }
+    }
+
+    Anchor = PlayerLocation;
+    bProjected = true;
+    return Slots.Num();
+}
+
+bool FCompanionFollowSlotRing::Claim(const AController* Claimant, const FVector& From, double Now, FVector& OutLocation)
+{
+    int32 Best = INDEX_NONE;
+    float BestDistSq = TNumericLimits<float>::Max();
+
+    for (int32 i = 0; i < Slots.Num(); ++i)
+    {
+        FSlot& Slot = Slots[i];
+        const AController* Holder = Slot.Claimant.Get();
+
+        // Already ours: keep it while it is still on the navmesh, so followers do not shuffle around
+        if (Holder == Claimant)
+        {
+            if (Slot.bValid)
+            {
+                Slot.ClaimTime = Now;
+                OutLocation = Slot.Location;
+                return true;
+            }
+            Slot.Claimant.Reset();
+            Holder = nullptr;
+        }
+
+        if (Holder || !Slot.bValid)
+        {
+            continue;
+        }
+
+        const float DistSq = FVector::DistSquared(From, Slot.Location);
+        if (DistSq < BestDistSq)
+        {
+            BestDistSq = DistSq;
+            Best = i;
+        }
+    }
+
+    if (Best == INDEX_NONE)
+    {
+        return false;
+    }
+
+    Slots[Best].Claimant = Claimant;
+    Slots[Best].ClaimTime = Now;
+    OutLocation = Slots[Best].Location;
+    return true;
+}
+
+void FCompanionFollowSlotRing::Release(const AController* Claimant)
+{
+    for (FSlot& Slot : Slots)
+    {
+        if (Slot.Claimant.Get() == Claimant)
+        {
+            Slot.Claimant.Reset();
+        }
+    }
+}
+
+void FCompanionFollowSlotRing::ExpireClaims(double Now, float Timeout)
+{
+    for (FSlot& Slot : Slots)
+    {
+        if (Slot.Claimant.IsValid() && Now - Slot.ClaimTime > Timeout)
+        {
+            Slot.Claimant.Reset();
+        }
+    }
+}
+
+bool FCompanionFollowSlotRing::HasClaims() const
+{
+    return Slots.ContainsByPredicate([](const FSlot& Slot) { return Slot.Claimant.IsValid(); });
+}
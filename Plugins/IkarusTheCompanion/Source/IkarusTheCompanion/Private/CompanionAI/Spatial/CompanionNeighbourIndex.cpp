@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionAI/Spatial/CompanionNeighbourIndex.h"
+#include "CompanionAI/CompanionControllers/AICompanionController.h"
+#include "Algo/Sort.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+
+FCompanionNeighbourIndex::FCompanionNeighbourIndex(float InCellSize)
+    : CellSize(FMath::Max(InCellSize, 100.f))
+{
+}
+
+FCompanionNeighbourIndex::~FCompanionNeighbourIndex()
+{
+    BuildTask.Wait();
+}
+
+void FCompanionNeighbourIndex::SetCellSize(float InCellSize)
+{
+    CellSize = FMath::Max(InCellSize, 100.f);
+}
+
+void FCompanionNeighbourIndex::Rebuild(UWorld& World)
+{
+    check(IsInGameThread());
+
+    if (BuildTask.IsValid() && !BuildTask.IsCompleted())
+    {
+        return;
+    }
+
+    if (bBackPending)
+    {
+        FrontIndex ^= 1;
+        bBackPending = false;
+    }
+
+    // Snapshot on the game thread: everything the worker touches is plain data from here on
+    FBuffer& Back = Buffers[FrontIndex ^ 1];
+    Back.Neighbours.Reset();
+    Back.InvCellSize = 1.f / CellSize;
+
+    for (TActorIterator<APawn> It(&World); It; ++It)
+    {
+        APawn* Pawn = *It;
+        if (!IsValid(Pawn))
+        {
+            continue;
+        }
+
+        FNeighbour& Neighbour = Back.Neighbours.AddDefaulted_GetRef();
+        Neighbour.Pawn = Pawn;
+        Neighbour.Location = Pawn->GetActorLocation();
+        Neighbour.Kind = Pawn->IsPlayerControlled() ? ECompanionNeighbourKind::Player
+            : Cast<AAICompanionController>(Pawn->GetController()) ? ECompanionNeighbourKind::Companion
+            : ECompanionNeighbourKind::NPC;
+    }
+
+    bBackPending = true;
+    BuildTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [&Back]() { Build(Back); });
+}
+
+void FCompanionNeighbourIndex::Build(FBuffer& Buffer)
+{
+    const float InvCellSize = Buffer.InvCellSize;
+    const auto KeyOf = [InvCellSize](const FNeighbour& Neighbour)
+    {
+        const FIntPoint Cell = ToCell(Neighbour.Location, InvCellSize);
+        return MakeKey(Cell.X, Cell.Y);
+    };
+
+    Algo::SortBy(Buffer.Neighbours, KeyOf);
+
+    Buffer.CellKeys.Reset();
+    Buffer.CellStarts.Reset();
+    for (int32 Idx = 0; Idx < Buffer.Neighbours.Num(); ++Idx)
+    {
+        const uint64 Key = KeyOf(Buffer.Neighbours[Idx]);
+        if (Buffer.CellKeys.Num() == 0 || Buffer.CellKeys.Last() != Key)
+        {
+            Buffer.CellKeys.Add(Key);
+            Buffer.CellStarts.Add(Idx);
+        }
+    }
+    Buffer.CellStarts.Add(Buffer.Neighbours.Num());
+}
+
+void FCompanionNeighbourIndex::Reset()
+{
+    BuildTask.Wait();
+    BuildTask = UE::Tasks::FTask();
+    bBackPending = false;
+
+    for (FBuffer& Buffer : Buffers)
+    {
+        Buffer.Neighbours.Reset();
+        Buffer.CellKeys.Reset();
+        Buffer.CellStarts.Reset();
+    }
+}
+
+void FCompanionNeighbourIndex::Summarise(const FVector& Origin, float Radius, const APawn* Self, FCompanionNeighbourSummary& OutSummary) const
+{
+    OutSummary = FCompanionNeighbourSummary();
+
+    float NearestDistSq = TNumericLimits<float>::Max();
+    ForEachWithin(Origin, Radius, [&](const FNeighbour& Neighbour, float DistSq)
+    {
+        if (Neighbour.Pawn.Get() == Self)
+        {
+            return;
+        }
+
+        switch (Neighbour.Kind)
+        {
+        case ECompanionNeighbourKind::Player:    ++OutSummary.NumPlayers;    break;
+        case ECompanionNeighbourKind::Companion: ++OutSummary.NumCompanions; break;
+        default:                                 ++OutSummary.NumNPCs;       break;
+        }
+
+        if (DistSq < NearestDistSq)
+        {
+            NearestDistSq = DistSq;
+            OutSummary.Nearest = Neighbour.Pawn;
+        }
+    });
+
+    OutSummary.NearestDistance = OutSummary.Total() > 0 ? FMath::Sqrt(NearestDistSq) : 0.f;
+}
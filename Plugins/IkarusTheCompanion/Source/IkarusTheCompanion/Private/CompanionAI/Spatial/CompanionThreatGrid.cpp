@@ -0,0 +1,192 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionAI/Spatial/CompanionThreatGrid.h"
+#include "GameFramework/Actor.h"
+
+FCompanionThreatGrid::FCompanionThreatGrid(float InCellSize)
+    : CellSize(FMath::Max(InCellSize, 100.f))
+    , InvCellSize(1.f / FMath::Max(InCellSize, 100.f))
+{
+}
+
+FIntPoint FCompanionThreatGrid::ToCell(const FVector& Location) const
+{
+    return FIntPoint(FMath::FloorToInt32(Location.X * InvCellSize), FMath::FloorToInt32(Location.Y * InvCellSize));
+}
+
+void FCompanionThreatGrid::Add(AActor* Actor, double Now)
+{
+    if (!Actor)
+    {
+        return;
+    }
+    if (const int32* EntryIndex = ActorToEntry.Find(Actor))
+    {
+        Entries[*EntryIndex].LastReportTime = Now;
+        return;
+    }
+
+    FEntry Entry;
+    Entry.Actor = Actor;
+    Entry.Key = Actor;
+    Entry.Location = Actor->GetActorLocation();
+    Entry.Cell = ToCell(Entry.Location);
+    Entry.LastReportTime = Now;
+
+    const int32 EntryIndex = Entries.Add(MoveTemp(Entry));
+    ActorToEntry.Add(Actor, EntryIndex);
+    AddToCell(Entries[EntryIndex].Cell, EntryIndex);
+}
+
+void FCompanionThreatGrid::Remove(const AActor* Actor)
+{
+    if (const int32* EntryIndex = ActorToEntry.Find(Actor))
+    {
+        RemoveEntry(*EntryIndex);
+    }
+}
+
+void FCompanionThreatGrid::RemoveEntry(int32 EntryIndex)
+{
+    const FEntry& Entry = Entries[EntryIndex];
+    RemoveFromCell(Entry.Cell, EntryIndex);
+    ActorToEntry.Remove(Entry.Key);
+    Entries.RemoveAt(EntryIndex);
+}
+
+void FCompanionThreatGrid::Refresh(double Now, float ForgetAfterSeconds)
+{
+    TArray<int32, TInlineAllocator<16>> Dead;
+
+    for (auto It = Entries.CreateIterator(); It; ++It)
+    {
+        FEntry& Entry = *It;
+        const AActor* Actor = Entry.Actor.Get();
+        if (!Actor || Now - Entry.LastReportTime > ForgetAfterSeconds)
+        {
+            Dead.Add(It.GetIndex());
+            continue;
+        }
+
+        Entry.Location = Actor->GetActorLocation();
+
+        // Only touch the cell map when the actor actually changed cells
+        const FIntPoint NewCell = ToCell(Entry.Location);
+        if (NewCell != Entry.Cell)
+        {
+            RemoveFromCell(Entry.Cell, It.GetIndex());
+            AddToCell(NewCell, It.GetIndex());
+            Entry.Cell = NewCell;
+        }
+    }
+
+    for (const int32 EntryIndex : Dead)
+    {
+        RemoveEntry(EntryIndex);
+    }
+}
+
+void FCompanionThreatGrid::AddToCell(const FIntPoint& Cell, int32 EntryIndex)
+{
+    Cells.FindOrAdd(Cell).Add(EntryIndex);
+}
+
+void FCompanionThreatGrid::RemoveFromCell(const FIntPoint& Cell, int32 EntryIndex)
+{
+    if (FCell* Occupants = Cells.Find(Cell))
+    {
+        Occupants->RemoveSingleSwap(EntryIndex, EAllowShrinking::No);
+        if (Occupants->Num() == 0)
+        {
+            Cells.Remove(Cell);
+        }
+    }
+}
+
+template<typename TVisitor>
+void FCompanionThreatGrid::ForEachWithin(const FVector& Origin, float Radius, TVisitor&& Visitor) const
+{
+    if (Entries.Num() == 0 || Radius <= 0.f)
+    {
+        return;
+    }
+
+    const float RadiusSq = FMath::Square(Radius);
+    const FIntPoint MinCell = ToCell(Origin - FVector(Radius, Radius, 0.f));
+    const FIntPoint MaxCell = ToCell(Origin + FVector(Radius, Radius, 0.f));
+
+    for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+        {
+            const FCell* Occupants = Cells.Find(FIntPoint(X, Y));
+            if (!Occupants)
+            {
+                continue;
+            }
+
+            for (const int32 EntryIndex : *Occupants)
+            {
+                const float DistSq = FVector::DistSquared(Origin, Entries[EntryIndex].Location);
+                if (DistSq <= RadiusSq && !Visitor(EntryIndex, DistSq))
+                {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+int32 FCompanionThreatGrid::QueryNearest(const FVector& Origin, float Radius, int32 MaxResults, TArray<FCompanionThreatInfo>& OutThreats) const
+{
+    OutThreats.Reset();
+    if (MaxResults <= 0)
+    {
+        return 0;
+    }
+
+    // Bounded max-heap on distance: the farthest kept threat sits on top and is evicted first
+    const auto FarthestFirst = [](const FCompanionThreatInfo& A, const FCompanionThreatInfo& B) { return A.Distance > B.Distance; };
+
+    ForEachWithin(Origin, Radius, [&](int32 EntryIndex, float DistSq)
+    {
+        const float Distance = FMath::Sqrt(DistSq);
+        if (OutThreats.Num() == MaxResults)
+        {
+            if (Distance >= OutThreats.HeapTop().Distance)
+            {
+                return true;
+            }
+            OutThreats.HeapPopDiscard(FarthestFirst, EAllowShrinking::No);
+        }
+
+        const FEntry& Entry = Entries[EntryIndex];
+        FCompanionThreatInfo Threat;
+        Threat.Actor = Entry.Actor;
+        Threat.Location = Entry.Location;
+        Threat.Distance = Distance;
+        OutThreats.HeapPush(Threat, FarthestFirst);
+        return true;
+    });
+
+    OutThreats.Sort([](const FCompanionThreatInfo& A, const FCompanionThreatInfo& B) { return A.Distance < B.Distance; });
+    return OutThreats.Num();
+}
+
+bool FCompanionThreatGrid::AnyWithin(const FVector& Origin, float Radius) const
+{
+    bool bFound = false;
+    ForEachWithin(Origin, Radius, [&bFound](int32, float)
+    {
+        bFound = true;
+        return false;
+    });
+    return bFound;
+}
+
+void FCompanionThreatGrid::Reset()
+{
+    Entries.Reset();
+    Cells.Reset();
+    ActorToEntry.Reset();
+}
@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionAI/Spatial/CompanionUnreachableCache.h"
+
+FCompanionUnreachableCache::FCompanionUnreachableCache(float InCellSize, float InBaseTTL, float InMaxTTL)
+    : CellSize(FMath::Max(InCellSize, 1.f))
+    , BaseTTL(FMath::Max(InBaseTTL, 0.f))
+    , MaxTTL(FMath::Max(InMaxTTL, InBaseTTL))
+{
+}
+
+FIntVector FCompanionUnreachableCache::ToCell(const FVector& Location) const
+{
+    return FIntVector(
+        FMath::FloorToInt32(Location.X / CellSize),
+        FMath::FloorToInt32(Location.Y / CellSize),
+        FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+void FCompanionUnreachableCache::MarkUnreachable(const FVector& Location, double Now)
+{
+    FEntry& Entry = Cells.FindOrAdd(ToCell(Location));
+    Entry.Failures = FMath::Min(Entry.Failures + 1, 16);
+
+    // 1x, 2x, 4x... the base TTL, capped
+    const double TTL = FMath::Min<double>(BaseTTL * static_cast<double>(1 << (Entry.Failures - 1)), MaxTTL);
+    Entry.ExpiresAt = FMath::Max(Entry.ExpiresAt, Now + TTL);
+}
+
+void FCompanionUnreachableCache::ClearUnreachable(const FVector& Location)
+{
+    Cells.Remove(ToCell(Location));
+}
+
+bool FCompanionUnreachableCache::IsUnreachable(const FVector& Location, double Now) const
+{
+    const FEntry* Entry = Cells.Find(ToCell(Location));
+    return Entry && Now < Entry->ExpiresAt;
+}
+
+void FCompanionUnreachableCache::Prune(double Now)
+{
+    // Expired cells linger for MaxTTL so a failure soon after expiry still escalates
+    for (auto It = Cells.CreateIterator(); It; ++It)
+    {
+        if (Now > It.Value().ExpiresAt + MaxTTL)
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionAI/Spatial/CompanionVisitedGrid.h"
+
+static_assert(FCompanionVisitedGrid::Dim == 64, "One torus row is stored as a single uint64");
+
+FCompanionVisitedGrid::FCompanionVisitedGrid(float InCellSize, float InMemorySeconds)
+    : CellSize(FMath::Max(InCellSize, 1.f))
+    , SliceSeconds(FMath::Max(InMemorySeconds, 1.f) / NumPlanes)
+{
+    Reset();
+}
+
+void FCompanionVisitedGrid::Reset()
+{
+    FMemory::Memzero(Planes);
+    for (int64& Slice : PlaneSlices)
+    {
+        Slice = -1;
+    }
+}
+
+FIntPoint FCompanionVisitedGrid::ToCell(const FVector& Location) const
+{
+    return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+int64 FCompanionVisitedGrid::SliceOf(double Now) const
+{
+    return FMath::Max<int64>(static_cast<int64>(Now / SliceSeconds), 0);
+}
+
+void FCompanionVisitedGrid::Mark(const FVector& Location, double Now)
+{
+    const int64 Slice = SliceOf(Now);
+    const int32 Plane = static_cast<int32>(Slice % NumPlanes);
+
+    // First mark of a new slice: the plane still holds marks from NumPlanes slices ago
+    if (PlaneSlices[Plane] != Slice)
+    {
+        FMemory::Memzero(Planes[Plane]);
+        PlaneSlices[Plane] = Slice;
+    }
+
+    const FIntPoint Cell = ToCell(Location);
+    Planes[Plane][Cell.Y & (Dim - 1)] |= uint64(1) << (Cell.X & (Dim - 1));
+}
+
+bool FCompanionVisitedGrid::TestCell(int32 X, int32 Y, int64 Slice) const
+{
+    const int32 Row = Y & (Dim - 1);
+    const uint64 Bit = uint64(1) << (X & (Dim - 1));
+
+    for (int32 Plane = 0; Plane < NumPlanes; ++Plane)
+    {
+        if (Slice - PlaneSlices[Plane] < NumPlanes && (Planes[Plane][Row] & Bit) != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FCompanionVisitedGrid::IsVisited(const FVector& Location, double Now) const
+{
+    const FIntPoint Cell = ToCell(Location);
+    return TestCell(Cell.X, Cell.Y, SliceOf(Now));
+}
+
+int32 FCompanionVisitedGrid::CountVisitedAround(const FVector& Location, double Now) const
+{
+    const FIntPoint Cell = ToCell(Location);
+    const int64 Slice = SliceOf(Now);
+
+    int32 Count = 0;
+    for (int32 Y = Cell.Y - 1; Y <= Cell.Y + 1; ++Y)
+    {
+        for (int32 X = Cell.X - 1; X <= Cell.X + 1; ++X)
+        {
+            Count += TestCell(X, Y, Slice) ? 1 : 0;
+        }
+    }
+    return Count;
+}
@@ -0,0 +1,743 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionAI/Subsystems/CompanionWorldSubsystem.h"
+#include "CompanionAI/CompanionControllers/AICompanionController.h"
+#include "CompanionInterfaces/CompanionVirtualState.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Engine/World.h"
+#include "NavigationSystem.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+namespace
+{
+    /** Write the SaveGame properties of one object */
+    void CaptureSaveGameProperties(UObject& Object, TArray<uint8>& OutData)
+    {
+        FMemoryWriter Writer(OutData, true);
+        FObjectAndNameAsStringProxyArchive Ar(Writer, true);
+        Ar.ArIsSaveGame = true;
+        Object.Serialize(Ar);
+    }
+
+    /** Read back what CaptureSaveGameProperties wrote */
+    void RestoreSaveGameProperties(UObject& Object, const TArray<uint8>& Data)
+    {
+        FMemoryReader Reader(Data, true);
+        FObjectAndNameAsStringProxyArchive Ar(Reader, true);
+        Ar.ArIsSaveGame = true;
+        Object.Serialize(Ar);
+    }
+
+    /** SaveGame properties of an actor followed by those of each component, keyed by component name */
+    void CaptureActorState(AActor& Actor, TArray<uint8>& OutData)
+    {
+        TArray<uint8> ActorData;
+        CaptureSaveGameProperties(Actor, ActorData);
+
+        FMemoryWriter Writer(OutData, true);
+        Writer << ActorData;
+
+        TInlineComponentArray<UActorComponent*> Components(&Actor);
+        int32 NumComponents = Components.Num();
+        Writer << NumComponents;
+        for (UActorComponent* Component : Components)
+        {
+            FString Name = Component->GetName();
+            TArray<uint8> ComponentData;
+            CaptureSaveGameProperties(*Component, ComponentData);
+            Writer << Name;
+            Writer << ComponentData;
+        }
+    }
+
+    /** Apply CaptureActorState data to a freshly spawned actor of the same class; unknown components are skipped */
+    void RestoreActorState(AActor& Actor, const TArray<uint8>& Data)
+    {
+        if (Data.Num() == 0)
+        {
+            return;
+        }
+
+        FMemoryReader Reader(Data, true);
+        TArray<uint8> ActorData;
+        Reader << ActorData;
+        RestoreSaveGameProperties(Actor, ActorData);
+
+        TInlineComponentArray<UActorComponent*> Components(&Actor);
+        int32 NumComponents = 0;
+        Reader << NumComponents;
+        for (int32 Index = 0; Index < NumComponents && !Reader.IsError(); ++Index)
+        {
+            FString Name;
+            TArray<uint8> ComponentData;
+            Reader << Name;
+            Reader << ComponentData;
+
+            UActorComponent* const* Component = Components.FindByPredicate([&Name](const UActorComponent* Candidate) { return Candidate->GetName() == Name; });
+            if (Component)
+            {
+                RestoreSaveGameProperties(**Component, ComponentData);
+            }
+        }
+    }
+}
+
+bool UCompanionWorldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // Companions only run in game worlds
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCompanionWorldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    ThreatGrid = FCompanionThreatGrid(ThreatCellSize);
+    NeighbourIndex.SetCellSize(NeighbourCellSize);
+    UnreachableCache = FCompanionUnreachableCache(UnreachableCellSize, UnreachableTTL, UnreachableMaxTTL);
+}
+
+void UCompanionWorldSubsystem::Deinitialize()
+{
+    for (const TWeakObjectPtr<AAICompanionController>& Controller : Controllers)
+    {
+        if (Controller.IsValid())
+        {
+            Controller->WorldSlotIndex = INDEX_NONE;
+        }
+    }
+
+    Controllers.Reset();
+    CompanionLocations.Reset();
+    OwnerLocations.Reset();
+    OwnerDistances.Reset();
+    OwnerProximities.Reset();
+    UpdateIntervals.Reset();
+    TimeUntilUpdate.Reset();
+    HasOwner.Reset();
+    DormantTimes.Reset();
+    TimeUntilHeavyUpdate.Reset();
+    VirtualLocations.Reset();
+    VirtualRecords.Reset();
+    WorkQueue.Reset();
+    RunningWork.Reset();
+    DeferredWork.Reset();
+    ThreatGrid.Reset();
+    NeighbourIndex.Reset();
+    FollowSlots.Reset();
+    VisitedGrids.Reset();
+    UnreachableCache.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UCompanionWorldSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCompanionWorldSubsystem, STATGROUP_Tickables);
+}
+
+void UCompanionWorldSubsystem::RegisterCompanion(AAICompanionController* Controller)
+{
+    if (!Controller || Controller->WorldSlotIndex != INDEX_NONE)
+    {
+        return;
+    }
+
+    Controller->WorldSlotIndex = Controllers.Add(Controller);
+    CompanionLocations.Add(FVector::ZeroVector);
+    OwnerLocations.Add(FVector::ZeroVector);
+    OwnerDistances.Add(0.f);
+    OwnerProximities.Add(0.f);
+    UpdateIntervals.Add(Controller->BlackboardUpdateInterval);
+    HasOwner.Add(false);
+    DormantTimes.Add(0.f);
+
+    // Random phase so companions spawned on the same frame do not refresh on the same frames
+    TimeUntilUpdate.Add(FMath::FRandRange(0.f, Controller->BlackboardUpdateInterval));
+    TimeUntilHeavyUpdate.Add(FMath::FRandRange(0.f, HeavyUpdateInterval));
+}
+
+void UCompanionWorldSubsystem::UnregisterCompanion(AAICompanionController* Controller)
+{
+    if (!Controller || !Controllers.IsValidIndex(Controller->WorldSlotIndex))
+    {
+        return;
+    }
+
+    RemoveAtSlot(Controller->WorldSlotIndex);
+    Controller->WorldSlotIndex = INDEX_NONE;
+    ReleaseFollowSlot(Controller);
+}
+
+void UCompanionWorldSubsystem::SetCompanionUpdateInterval(const AAICompanionController* Controller, float Interval)
+{
+    if (Controller && UpdateIntervals.IsValidIndex(Controller->WorldSlotIndex))
+    {
+        UpdateIntervals[Controller->WorldSlotIndex] = Interval;
+        TimeUntilUpdate[Controller->WorldSlotIndex] = FMath::Min(TimeUntilUpdate[Controller->WorldSlotIndex], Interval);
+    }
+}
+
+void UCompanionWorldSubsystem::RemoveAtSlot(int32 Slot)
+{
+    Controllers.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    CompanionLocations.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    OwnerLocations.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    OwnerDistances.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    OwnerProximities.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    UpdateIntervals.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    TimeUntilUpdate.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    HasOwner.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    DormantTimes.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    TimeUntilHeavyUpdate.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+
+    // The last companion was swapped into this slot – fix up its index
+    if (Controllers.IsValidIndex(Slot) && Controllers[Slot].IsValid())
+    {
+        Controllers[Slot]->WorldSlotIndex = Slot;
+    }
+}
+
+void UCompanionWorldSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    const int32 Num = Controllers.Num();
+    DueIndices.Reset();
+    StaleControllers.Reset();
+
+    /* ---------- pass 1: schedule & gather positions ---------- */
+    for (int32 i = 0; i < Num; ++i)
+    {
+        TimeUntilUpdate[i] -= DeltaTime;
+        if (TimeUntilUpdate[i] > 0.f)
+        {
+            continue;
+        }
+        TimeUntilUpdate[i] = FMath::Max(TimeUntilUpdate[i] + UpdateIntervals[i], 0.f);
+
+        const AAICompanionController* Controller = Controllers[i].Get();
+        const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+        if (!Pawn)
+        {
+            StaleControllers.Add(Controllers[i]);
+            continue;
+        }
+
+        CompanionLocations[i] = Pawn->GetActorLocation();
+
+        const ACharacter* Owner = Controller->GetOwnerPlayer();
+        HasOwner[i] = Owner != nullptr;
+        if (Owner)
+        {
+            OwnerLocations[i] = Owner->GetActorLocation();
+        }
+
+        DueIndices.Add(i);
+    }
+
+    /* ---------- pass 2: distance & proximity for every due companion ---------- */
+    for (const int32 i : DueIndices)
+    {
+        const float Distance = HasOwner[i] ? FVector::Dist(CompanionLocations[i], OwnerLocations[i]) : 0.f;
+        OwnerDistances[i] = Distance;
+        OwnerProximities[i] = FMath::Clamp(1.f - Distance / MaxProximityRange, 0.f, 1.f);
+    }
+
+    /* ---------- pass 3: push results to blackboards ---------- */
+    for (const int32 i : DueIndices)
+    {
+        if (AAICompanionController* Controller = Controllers[i].Get())
+        {
+            // Hibernating companions only check whether their owner came back close enough to wake them
+            if (Controller->IsHibernating())
+            {
+                if (HasOwner[i])
+                {
+                    Controller->UpdateHibernationOwnerDistance(OwnerDistances[i]);
+                }
+                continue;
+            }
+            Controller->ApplyOwnerProximity(CompanionLocations[i], OwnerLocations[i], OwnerDistances[i], OwnerProximities[i], HasOwner[i]);
+        }
+    }
+
+    /* ---------- threat grid: re-bucket hostiles that changed cells and forget stale ones before anyone queries it ---------- */
+    if (ThreatGrid.Num() > 0)
+    {
+        ThreatGrid.Refresh(GetWorld()->GetTimeSeconds(), ThreatForgetSeconds);
+    }
+
+    /* ---------- neighbour index: publish the last sort, start the next one on a worker ---------- */
+    if (Num > 0)
+    {
+        NeighbourIndex.Rebuild(*GetWorld());
+    }
+
+    /* ---------- follow slots: re-project around players that moved ---------- */
+    if (FollowSlots.Num() > 0)
+    {
+        UpdateFollowSlots();
+    }
+
+    /* ---------- heavy work, phase-jittered and budgeted ---------- */
+    RunHeavyUpdates(DeltaTime);
+
+    /* ---------- time-sliced work queue ---------- */
+    RunWorkQueue();
+
+    /* ---------- pass 4: batch perception, then flush every write queued this frame ---------- */
+    for (const TWeakObjectPtr<AAICompanionController>& Controller : Controllers)
+    {
+        if (!Controller.IsValid())
+        {
+            continue;
+        }
+        Controller->ProcessPendingStimuli();
+        if (Controller->BlackboardWrites.HasPendingWrites())
+        {
+            Controller->FlushBlackboardWrites();
+        }
+    }
+
+    /* ---------- drop controllers that died without unpossessing ---------- */
+    // Anything above may have unregistered companions and swapped slots around, so look each one up again
+    bool bHasDeadSlots = false;
+    for (const TWeakObjectPtr<AAICompanionController>& Stale : StaleControllers)
+    {
+        AAICompanionController* Controller = Stale.Get();
+        if (!Controller)
+        {
+            bHasDeadSlots = true;
+            continue;
+        }
+        if (!Controller->GetPawn() && Controllers.IsValidIndex(Controller->WorldSlotIndex))
+        {
+            RemoveAtSlot(Controller->WorldSlotIndex);
+            Controller->WorldSlotIndex = INDEX_NONE;
+        }
+    }
+    if (bHasDeadSlots)
+    {
+        for (int32 Slot = Controllers.Num() - 1; Slot >= 0; --Slot)
+        {
+            if (!Controllers[Slot].IsValid())
+            {
+                RemoveAtSlot(Slot);
+            }
+        }
+    }
+
+    /* ---------- AI LOD ---------- */
+    TimeUntilLODEvaluation -= DeltaTime;
+    if (TimeUntilLODEvaluation <= 0.f)
+    {
+        TimeUntilLODEvaluation = LODEvaluationInterval;
+        EvaluateAILOD();
+
+        UnreachableCache.Prune(GetWorld()->GetTimeSeconds());
+
+        // Forget visited grids of owners that are gone
+        for (auto It = VisitedGrids.CreateIterator(); It; ++It)
+        {
+            if (!It.Key().ResolveObjectPtr())
+            {
+                It.RemoveCurrent();
+            }
+        }
+    }
+}
+
+void UCompanionWorldSubsystem::RegisterThreat(AActor* Threat)
+{
+    ThreatGrid.Add(Threat, GetWorld()->GetTimeSeconds());
+}
+
+bool UCompanionWorldSubsystem::ClaimFollowSlot(const AActor* Player, const AController* Claimant, FVector& OutLocation)
+{
+    const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+    if (!Player || !Claimant || !NavSys)
+    {
+        return false;
+    }
+
+    FFollowSlotEntry& Entry = FollowSlots.FindOrAdd(Player);
+    if (!Entry.Ring.IsInitialized())
+    {
+        Entry.Player = Player;
+        Entry.Ring.Initialize(FollowSlotsPerPlayer, FollowSlotRadius);
+    }
+
+    // First claim around this player, or the player moved since the last tick: project now
+    const FVector PlayerLocation = Player->GetActorLocation();
+    if (Entry.Ring.NeedsReprojection(PlayerLocation, FollowSlotReprojectDistance))
+    {
+        FollowSlotProjections += Entry.Ring.Reproject(*NavSys, PlayerLocation);
+    }
+
+    const APawn* ClaimantPawn = Claimant->GetPawn();
+    return Entry.Ring.Claim(Claimant, ClaimantPawn ? ClaimantPawn->GetActorLocation() : PlayerLocation, GetWorld()->GetTimeSeconds(), OutLocation);
+}
+
+void UCompanionWorldSubsystem::ReleaseFollowSlot(const AController* Claimant)
+{
+    for (TPair<TObjectKey<AActor>, FFollowSlotEntry>& Pair : FollowSlots)
+    {
+        Pair.Value.Ring.Release(Claimant);
+    }
+}
+
+void UCompanionWorldSubsystem::UpdateFollowSlots()
+{
+    const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    for (auto It = FollowSlots.CreateIterator(); It; ++It)
+    {
+        FFollowSlotEntry& Entry = It.Value();
+        const AActor* Player = Entry.Player.Get();
+
+        // Followers that switched branches, stayed or hibernate stop renewing their claims
+        Entry.Ring.ExpireClaims(Now, FollowSlotClaimTimeout);
+        if (!Player || !Entry.Ring.HasClaims())
+        {
+            It.RemoveCurrent();
+            continue;
+        }
+
+        // One projection per slot per player move, shared by every follower
+        const FVector PlayerLocation = Player->GetActorLocation();
+        if (NavSys && Entry.Ring.NeedsReprojection(PlayerLocation, FollowSlotReprojectDistance))
+        {
+            FollowSlotProjections += Entry.Ring.Reproject(*NavSys, PlayerLocation);
+        }
+    }
+}
+
+FCompanionVisitedGrid& UCompanionWorldSubsystem::GetVisitedGrid(const AActor* Owner)
+{
+    if (FCompanionVisitedGrid* Grid = VisitedGrids.Find(Owner))
+    {
+        return *Grid;
+    }
+    return VisitedGrids.Emplace(Owner, FCompanionVisitedGrid(VisitedCellSize, VisitedMemorySeconds));
+}
+
+void UCompanionWorldSubsystem::MarkUnreachable(const FVector& Location)
+{
+    UnreachableCache.MarkUnreachable(Location, GetWorld()->GetTimeSeconds());
+}
+
+void UCompanionWorldSubsystem::ClearUnreachable(const FVector& Location)
+{
+    UnreachableCache.ClearUnreachable(Location);
+}
+
+bool UCompanionWorldSubsystem::IsUnreachable(const FVector& Location) const
+{
+    return UnreachableCache.IsUnreachable(Location, GetWorld()->GetTimeSeconds());
+}
+
+uint32 UCompanionWorldSubsystem::SubmitWork(const UObject* Owner, TFunction<void()>&& Work)
+{
+    FWorkItem& Item = WorkQueue.AddDefaulted_GetRef();
+    Item.Handle = NextWorkHandle++;
+    Item.Owner = Owner;
+    Item.Work = MoveTemp(Work);
+
+    if (NextWorkHandle == 0)
+    {
+        NextWorkHandle = 1;
+    }
+    return Item.Handle;
+}
+
+void UCompanionWorldSubsystem::CancelWork(uint32 Handle)
+{
+    if (Handle == 0)
+    {
+        return;
+    }
+
+    const auto MatchesHandle = [Handle](const FWorkItem& Item) { return Item.Handle == Handle; };
+    WorkQueue.RemoveAll(MatchesHandle);
+    DeferredWork.RemoveAll(MatchesHandle);
+
+    // Cancelled from inside another work item: drop it from the batch being run
+    for (FWorkItem& Item : RunningWork)
+    {
+        if (Item.Handle == Handle)
+        {
+            Item.Owner.Reset();
+        }
+    }
+}
+
+void UCompanionWorldSubsystem::RunWorkQueue()
+{
+    LastFrameWorkMs = 0.f;
+    if (WorkQueue.Num() == 0)
+    {
+        return;
+    }
+
+    // Work submitted while we run lands at the back of WorkQueue and waits for next frame
+    RunningWork = MoveTemp(WorkQueue);
+    WorkQueue.Reset();
+    DeferredWork.Reset();
+    OwnersServedThisFrame.Reset();
+
+    const double StartTime = FPlatformTime::Seconds();
+    const double BudgetSeconds = WorkBudgetMs * 0.001;
+    bool bBudgetSpent = false;
+
+    for (int32 Index = 0; Index < RunningWork.Num(); ++Index)
+    {
+        FWorkItem& Item = RunningWork[Index];
+        const UObject* Owner = Item.Owner.Get();
+        if (!Owner)
+        {
+            continue;
+        }
+
+        // Round-robin: an owner gets one item per frame while anyone else is waiting
+        bool bAlreadyServed = false;
+        OwnersServedThisFrame.Add(Owner, &bAlreadyServed);
+        if (bBudgetSpent || bAlreadyServed)
+        {
+            DeferredWork.Add(MoveTemp(Item));
+            continue;
+        }
+
+        const TFunction<void()> Work = MoveTemp(Item.Work);
+        Work();
+        bBudgetSpent = FPlatformTime::Seconds() - StartTime >= BudgetSeconds;
+    }
+
+    LastFrameWorkMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    RunningWork.Reset();
+
+    // Rolled-over items keep their order ahead of anything submitted this frame
+    DeferredWork.Append(MoveTemp(WorkQueue));
+    Swap(WorkQueue, DeferredWork);
+    DeferredWork.Reset();
+}
+
+void UCompanionWorldSubsystem::RunHeavyUpdates(float DeltaTime)
+{
+    const int32 Num = Controllers.Num();
+    for (int32 i = 0; i < Num; ++i)
+    {
+        TimeUntilHeavyUpdate[i] -= DeltaTime;
+    }
+
+    // Scan from the cursor so companions skipped for budget are first in line next frame
+    int32 NumRun = 0;
+    int32 Slot = Num > 0 ? HeavyWorkCursor % Num : 0;
+    for (int32 Scanned = 0; Scanned < Num && NumRun < MaxHeavyUpdatesPerFrame; ++Scanned, Slot = (Slot + 1) % Num)
+    {
+        if (TimeUntilHeavyUpdate[Slot] > 0.f)
+        {
+            continue;
+        }
+
+        AAICompanionController* Controller = Controllers[Slot].Get();
+        if (!Controller || !Controller->GetPawn() || Controller->IsHibernating())
+        {
+            continue;
+        }
+
+        Controller->RunHeavyUpdate();
+        TimeUntilHeavyUpdate[Slot] = FMath::Max(TimeUntilHeavyUpdate[Slot] + FMath::Max(HeavyUpdateInterval, UpdateIntervals[Slot]), 0.f);
+        ++NumRun;
+    }
+    HeavyWorkCursor = Slot;
+
+    if (HeavyWorkHistogram.Num() != MaxHeavyUpdatesPerFrame + 1)
+    {
+        HeavyWorkHistogram.SetNumZeroed(MaxHeavyUpdatesPerFrame + 1);
+    }
+    ++HeavyWorkHistogram[FMath::Min(NumRun, MaxHeavyUpdatesPerFrame)];
+}
+
+void UCompanionWorldSubsystem::ResetHeavyWorkHistogram()
+{
+    HeavyWorkHistogram.Reset();
+}
+
+void UCompanionWorldSubsystem::LogHeavyWorkHistogram() const
+{
+    UE_LOG(LogTemp, Log, TEXT("CompanionWorldSubsystem: heavy updates per frame (%d companions, budget %d)"), Controllers.Num(), MaxHeavyUpdatesPerFrame);
+    for (int32 Count = 0; Count < HeavyWorkHistogram.Num(); ++Count)
+    {
+        UE_LOG(LogTemp, Log, TEXT("  %d: %d frames"), Count, HeavyWorkHistogram[Count]);
+    }
+}
+
+void UCompanionWorldSubsystem::EvaluateAILOD()
+{
+    /* ---------- gather player views once ---------- */
+    ViewLocations.Reset();
+    ViewDirections.Reset();
+
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PC = It->Get();
+        if (!PC || !PC->GetPawn())
+        {
+            continue;
+        }
+
+        FVector ViewLocation;
+        FRotator ViewRotation;
+        PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+        ViewLocations.Add(ViewLocation);
+        ViewDirections.Add(ViewRotation.Vector());
+    }
+
+    const float CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(OnScreenHalfAngleDegrees));
+    PendingVirtualise.Reset();
+
+    /* ---------- significance distance per companion ---------- */
+    for (int32 i = 0; i < Controllers.Num(); ++i)
+    {
+        AAICompanionController* Controller = Controllers[i].Get();
+        const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+        if (!Pawn)
+        {
+            continue;
+        }
+
+        const FVector Location = Pawn->GetActorLocation();
+        float Significance = ViewLocations.Num() > 0 ? FLT_MAX : 0.f;
+
+        for (int32 v = 0; v < ViewLocations.Num(); ++v)
+        {
+            const FVector ToCompanion = Location - ViewLocations[v];
+            const float Distance = ToCompanion.Size();
+            const bool bOnScreen = Distance > KINDA_SMALL_NUMBER
+                && FVector::DotProduct(ToCompanion / Distance, ViewDirections[v]) >= CosHalfAngle;
+
+            Significance = FMath::Min(Significance, bOnScreen ? Distance * OnScreenDistanceScale : Distance);
+        }
+
+        Controller->UpdateAILOD(Significance);
+
+        // Companions that stay dormant long enough are collapsed into virtual records
+        DormantTimes[i] = Controller->GetAILOD() == ECompanionAILOD::Dormant ? DormantTimes[i] + LODEvaluationInterval : 0.f;
+        if (DormantTimes[i] >= VirtualiseAfterSeconds && Controller->CanVirtualise())
+        {
+            PendingVirtualise.Add(Controller);
+        }
+    }
+
+    /* ---------- collapse / rehydrate ---------- */
+    for (const TWeakObjectPtr<AAICompanionController>& Controller : PendingVirtualise)
+    {
+        VirtualiseCompanion(Controller.Get());
+    }
+
+    const float RehydrateDistanceSq = FMath::Square(RehydrateDistance);
+    for (int32 v = VirtualLocations.Num() - 1; v >= 0; --v)
+    {
+        for (const FVector& ViewLocation : ViewLocations)
+        {
+            if (FVector::DistSquared(VirtualLocations[v], ViewLocation) <= RehydrateDistanceSq)
+            {
+                RehydrateCompanion(v);
+                break;
+            }
+        }
+    }
+}
+
+bool UCompanionWorldSubsystem::VirtualiseCompanion(AAICompanionController* Controller)
+{
+    APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+    if (!Pawn)
+    {
+        return false;
+    }
+
+    FVirtualCompanionRecord& Record = VirtualRecords.AddDefaulted_GetRef();
+    Record.PawnClass = Pawn->GetClass();
+    Record.ControllerClass = Controller->GetClass();
+    Record.Transform = Pawn->GetActorTransform();
+    Record.OwnerPlayer = Controller->GetOwnerPlayer();
+    Record.bStayCommanded = Controller->IsStayCommanded();
+
+    if (const UBlackboardComponent* BB = Controller->GetBlackboardComponent())
+    {
+        Record.Blackboard.Capture(*BB);
+    }
+
+    // Let the pawn stash anything that is not already a SaveGame property, then keep those
+    if (Pawn->Implements<UCompanionVirtualState>())
+    {
+        ICompanionVirtualState::Execute_OnCompanionVirtualised(Pawn);
+    }
+    CaptureActorState(*Pawn, Record.PawnState);
+    CaptureSaveGameProperties(*Controller, Record.ControllerState);
+
+    VirtualLocations.Add(Record.Transform.GetLocation());
+
+    UE_LOG(LogTemp, Log, TEXT("CompanionWorldSubsystem: Virtualised %s (%d virtual companions)"), *GetNameSafe(Pawn), VirtualRecords.Num());
+
+    // Unpossess unregisters the controller from the batched arrays
+    Controller->UnPossess();
+    Pawn->Destroy();
+    Controller->Destroy();
+    return true;
+}
+
+void UCompanionWorldSubsystem::RehydrateCompanion(int32 VirtualIndex)
+{
+    UWorld* World = GetWorld();
+    FVirtualCompanionRecord Record = MoveTemp(VirtualRecords[VirtualIndex]);
+    VirtualRecords.RemoveAtSwap(VirtualIndex, 1, EAllowShrinking::No);
+    VirtualLocations.RemoveAtSwap(VirtualIndex, 1, EAllowShrinking::No);
+
+    if (!World || !Record.PawnClass || !Record.ControllerClass)
+    {
+        return;
+    }
+
+    // Spawn without auto-possession so the blackboard can be restored before the tree starts
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+    SpawnParams.bDeferConstruction = true;
+
+    APawn* Pawn = World->SpawnActor<APawn>(Record.PawnClass, Record.Transform, SpawnParams);
+    if (!Pawn)
+    {
+        return;
+    }
+    Pawn->AutoPossessAI = EAutoPossessAI::Disabled;
+    Pawn->FinishSpawning(Record.Transform);
+    RestoreActorState(*Pawn, Record.PawnState);
+
+    AAICompanionController* Controller = World->SpawnActor<AAICompanionController>(Record.ControllerClass, Record.Transform);
+    if (!Controller)
+    {
+        Pawn->Destroy();
+        return;
+    }
+
+    if (Record.ControllerState.Num() > 0)
+    {
+        RestoreSaveGameProperties(*Controller, Record.ControllerState);
+    }
+    Controller->PrepareRehydration(Record.Blackboard, Record.OwnerPlayer.Get(), Record.bStayCommanded);
+    Controller->Possess(Pawn);
+
+    if (Pawn->Implements<UCompanionVirtualState>())
+    {
+        ICompanionVirtualState::Execute_OnCompanionRehydrated(Pawn);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("CompanionWorldSubsystem: Rehydrated %s (%d virtual companions)"), *GetNameSafe(Pawn), VirtualRecords.Num());
+}
@@ -0,0 +1,161 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardKeys.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "UObject/ObjectKey.h"
+#include "Engine/World.h"
+
+namespace
+{
+    /** Resolve a single typed key; mismatched types stay invalid so writes are skipped up front */
+    template<typename TKeyType>
+    void ResolveKey(const UBlackboardData& Asset, TCompanionBlackboardKey<TKeyType>& Key, const FName KeyName)
+    {
+        const FBlackboard::FKey KeyID = Asset.GetKeyID(KeyName);
+        const FBlackboardEntry* Entry = Asset.GetKey(KeyID);
+        Key.ID = (Entry && Entry->KeyType && Entry->KeyType->IsA<TKeyType>()) ? KeyID : FBlackboard::InvalidKey;
+    }
+}
+
+const FCompanionBlackboardKeys& FCompanionBlackboardKeys::Get(const UBlackboardData* Asset)
+{
+    static const FCompanionBlackboardKeys InvalidKeys;
+
+    // The null lookup also runs from controller constructors, which may be on a loading thread
+    if (!Asset)
+    {
+        return InvalidKeys;
+    }
+
+    check(IsInGameThread());
+
+    TUniquePtr<FCompanionBlackboardKeys>& Keys = GetRegistries().FindOrAdd(FObjectKey(Asset));
+    if (!Keys)
+    {
+        Keys = MakeUnique<FCompanionBlackboardKeys>();
+        Keys->Resolve(*Asset);
+    }
+    return *Keys;
+}
+
+const FCompanionBlackboardKeys& FCompanionBlackboardKeys::Get(const UBlackboardComponent& Blackboard)
+{
+    return Get(Blackboard.GetBlackboardAsset());
+}
+
+TMap<FObjectKey, TUniquePtr<FCompanionBlackboardKeys>>& FCompanionBlackboardKeys::GetRegistries()
+{
+    static TMap<FObjectKey, TUniquePtr<FCompanionBlackboardKeys>> Registries;
+    static const bool bHooked = []()
+    {
+        UBlackboardData::OnUpdateKeys.AddStatic(&FCompanionBlackboardKeys::HandleKeysUpdated);
+        FWorldDelegates::OnWorldCleanup.AddStatic(&FCompanionBlackboardKeys::HandleWorldCleanup);
+        return true;
+    }();
+    (void)bHooked;
+    return Registries;
+}
+
+void FCompanionBlackboardKeys::HandleKeysUpdated(UBlackboardData* Asset)
+{
+    // Resolve again in place: controllers keep a pointer to their registry
+    if (TUniquePtr<FCompanionBlackboardKeys>* Keys = Asset ? GetRegistries().Find(FObjectKey(Asset)) : nullptr)
+    {
+        (*Keys)->Resolve(*Asset);
+    }
+}
+
+void FCompanionBlackboardKeys::HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+    for (auto It = GetRegistries().CreateIterator(); It; ++It)
+    {
+        if (!It.Key().ResolveObjectPtr())
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+void FCompanionBlackboardKeys::LogWriteStats() const
+{
+    for (const TPair<FName, const FCompanionBlackboardWriteStats*>& Entry : WriteStats)
+    {
+        const FCompanionBlackboardWriteStats& Stats = *Entry.Value;
+        const uint32 Total = Stats.Applied + Stats.Suppressed;
+        if (Total > 0)
+        {
+            UE_LOG(LogTemp, Log, TEXT("%s: %u applied, %u suppressed (%.0f%% skipped)"),
+                *Entry.Key.ToString(), Stats.Applied, Stats.Suppressed, 100.0f * Stats.Suppressed / Total);
+        }
+    }
+}
+
+void FCompanionBlackboardKeys::Resolve(const UBlackboardData& Asset)
+{
+    WriteStats.Reset();
+
+    // Resolve a key, set its write tolerance and expose its counters to LogWriteStats
+    auto ResolveTracked = [this, &Asset](auto& Key, const TCHAR* KeyName, float Tolerance)
+    {
+        ResolveKey(Asset, Key, KeyName);
+        Key.Tolerance = Tolerance;
+        WriteStats.Emplace(KeyName, &Key.Stats);
+    };
+
+    // References
+    ResolveKey(Asset, SelfActor,               TEXT("SelfActor"));
+    ResolveKey(Asset, CompanionRef,            TEXT("CompanionRef"));
+    ResolveKey(Asset, PlayerRef,               TEXT("PlayerRef"));
+    ResolveKey(Asset, ThreatActor,             TEXT("ThreatActor"));
+    ResolveKey(Asset, ResourceActor,           TEXT("ResourceActor"));
+
+    // Locations
+    ResolveKey(Asset, HomeLocation,            TEXT("HomeLocation"));
+    ResolveKey(Asset, ThreatLocation,          TEXT("ThreatLocation"));
+    ResolveKey(Asset, ResourceLocation,        TEXT("ResourceLocation"));
+
+    // Owner/companion distances written by the batched proximity pass; a few centimetres of drift is noise
+    ResolveTracked(OwnerLocation,           TEXT("OwnerLocation"),           5.0f);
+    ResolveTracked(CompanionLocation,       TEXT("CompanionLocation"),       5.0f);
+    ResolveTracked(LastKnownPlayerLocation, TEXT("LastKnownPlayerLocation"), 5.0f);
+    ResolveTracked(OwnerDistance,           TEXT("OwnerDistance"),           5.0f);
+    ResolveTracked(CompanionDistance,       TEXT("CompanionDistance"),       5.0f);
+    ResolveTracked(OwnerProximity,          TEXT("OwnerProximity"),          0.0025f);
+    ResolveTracked(CompanionProximity,      TEXT("CompanionProximity"),      0.0025f);
+
+    // Utility scores
+    ResolveKey(Asset, IdleScore,               TEXT("IdleScore"));
+    ResolveKey(Asset, FollowScore,             TEXT("FollowScore"));
+    ResolveKey(Asset, PatrolScore,             TEXT("PatrolScore"));
+    ResolveKey(Asset, GatherScore,             TEXT("GatherScore"));
+    ResolveKey(Asset, CombatScore,             TEXT("CombatScore"));
+    ResolveKey(Asset, ExplorationPercentage,   TEXT("ExplorationPercentage"));
+
+    // Task state
+    ResolveKey(Asset, CurrentTaskType,         TEXT("CurrentTaskType"));
+    ResolveKey(Asset, IsTaskActive,            TEXT("IsTaskActive"));
+    ResolveKey(Asset, IsFollowing,             TEXT("IsFollowing"));
+    ResolveKey(Asset, IsPatrolling,            TEXT("IsPatrolling"));
+    ResolveKey(Asset, IsGathering,             TEXT("IsGathering"));
+    ResolveKey(Asset, HasValidTarget,          TEXT("HasValidTarget"));
+
+    // Awareness
+    ResolveKey(Asset, IsOwnerSeen,             TEXT("IsOwnerSeen"));
+    ResolveKey(Asset, IsPlayerSeen,            TEXT("IsPlayerSeen"));
+    ResolveKey(Asset, IsOwnerInDanger,         TEXT("IsOwnerInDanger"));
+    ResolveKey(Asset, IsSelfInDanger,          TEXT("IsSelfInDanger"));
+    ResolveKey(Asset, IsThreatDetected,        TEXT("IsThreatDetected"));
+    ResolveKey(Asset, IsResourceDetected,      TEXT("IsResourceDetected"));
+
+    // Social; assets without these keys simply skip the writes
+    ResolveKey(Asset, NearbyPlayerCount,       TEXT("NearbyPlayerCount"));
+    ResolveKey(Asset, NearbyCompanionCount,    TEXT("NearbyCompanionCount"));
+    ResolveKey(Asset, NearbyNPCCount,          TEXT("NearbyNPCCount"));
+    ResolveKey(Asset, NearestNeighbour,        TEXT("NearestNeighbour"));
+
+    // Survival
+    ResolveKey(Asset, InventorySpace,          TEXT("InventorySpace"));
+    ResolveKey(Asset, ResourceAmount,          TEXT("ResourceAmount"));
+    ResolveKey(Asset, CurrentStamina,          TEXT("CurrentStamina"));
+    ResolveKey(Asset, MaxStamina,              TEXT("MaxStamina"));
+}
@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardSnapshot.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Class.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+bool FCompanionBlackboardSnapshot::IsRawCopyable(const UBlackboardKeyType* KeyType)
+{
+    // Instanced keys keep state outside the value memory; strings and structs own heap data
+    if (!KeyType || KeyType->HasInstance())
+    {
+        return false;
+    }
+
+    return KeyType->IsA<UBlackboardKeyType_Bool>()
+        || KeyType->IsA<UBlackboardKeyType_Int>()
+        || KeyType->IsA<UBlackboardKeyType_Float>()
+        || KeyType->IsA<UBlackboardKeyType_Enum>()
+        || KeyType->IsA<UBlackboardKeyType_NativeEnum>()
+        || KeyType->IsA<UBlackboardKeyType_Name>()
+        || KeyType->IsA<UBlackboardKeyType_Vector>()
+        || KeyType->IsA<UBlackboardKeyType_Rotator>()
+        || KeyType->IsA<UBlackboardKeyType_Object>()
+        || KeyType->IsA<UBlackboardKeyType_Class>();
+}
+
+void FCompanionBlackboardSnapshot::Capture(const UBlackboardComponent& Blackboard)
+{
+    Reset();
+
+    const UBlackboardData* BlackboardAsset = Blackboard.GetBlackboardAsset();
+    if (!BlackboardAsset)
+    {
+        return;
+    }
+    Asset = BlackboardAsset;
+
+    const int32 NumKeys = Blackboard.GetNumKeys();
+    for (FBlackboard::FKey KeyID = 0; KeyID < NumKeys; ++KeyID)
+    {
+        const FBlackboardEntry* Key = BlackboardAsset->GetKey(KeyID);
+        const uint8* RawData = Blackboard.GetKeyRawData(KeyID);
+        if (!Key || !RawData || !IsRawCopyable(Key->KeyType))
+        {
+            continue;
+        }
+
+        FEntry& Entry = Entries.AddDefaulted_GetRef();
+        Entry.KeyID = KeyID;
+        Entry.Offset = static_cast<uint16>(Values.Num());
+        Entry.Size = static_cast<uint16>(Key->KeyType->GetValueSize());
+        Values.Append(RawData, Entry.Size);
+    }
+}
+
+bool FCompanionBlackboardSnapshot::Restore(UBlackboardComponent& Blackboard) const
+{
+    if (IsEmpty() || Blackboard.GetBlackboardAsset() != Asset.Get())
+    {
+        return false;
+    }
+
+    for (const FEntry& Entry : Entries)
+    {
+        if (uint8* RawData = Blackboard.GetKeyRawData(Entry.KeyID))
+        {
+            FMemory::Memcpy(RawData, Values.GetData() + Entry.Offset, Entry.Size);
+        }
+    }
+
+    return true;
+}
+
+void FCompanionBlackboardSnapshot::Reset()
+{
+    Asset.Reset();
+    Entries.Reset();
+    Values.Reset();
+}
@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardWriteBuffer.h"
+#include "BrainComponent.h"
+
+void FCompanionBlackboardWriteBuffer::Flush(UBlackboardComponent& Blackboard)
+{
+    if (Writes.Num() == 0)
+    {
+        return;
+    }
+
+    // Notifications for changed keys are queued (once per key) and sent after all values land,
+    // so decorators see a consistent blackboard and re-evaluate once per flush.
+    // The blackboard pause is a single flag shared with UBrainComponent::PauseLogic, so a paused
+    // brain already queues notifications and must not have them resumed from here
+    const UBrainComponent* BrainComponent = Blackboard.GetBrainComponent();
+    const bool bPauseNotifications = !BrainComponent || !BrainComponent->IsPaused();
+
+    if (bPauseNotifications)
+    {
+        Blackboard.PauseObserverNotifications();
+    }
+    for (const FPendingWrite& Pending : Writes)
+    {
+        Pending.Apply(Blackboard, Pending.KeyID, Values.GetData() + Pending.Offset);
+    }
+    if (bPauseNotifications)
+    {
+        Blackboard.ResumeObserverNotifications(true);
+    }
+
+    Reset();
+}
+
+void FCompanionBlackboardWriteBuffer::Reset()
+{
+    Writes.Reset();
+    Values.Reset();
+}
@@ -24,9 +24,25 @@ void UCompanionInteraction::TickComponent(float DeltaTime, ELevelTick TickType,
     if (GetOwnerRole() != ROLE_AutonomousProxy && !GetOwner()->HasAuthority())
         return;
     
-    // Find interactable each tick
-    AActor* NewInteractable = FindBestInteractable();
+    // One async sweep in flight at a time; its result lands with next frame's scene queries
+    if (PendingSweep.IsValid())
+    {
+        return;
+    }
+    
+    RequestInteractionSweep();
+}
+
+void UCompanionInteraction::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // A sweep still in flight reports to a weakly bound delegate; forgetting the handle is enough
+    PendingSweep = FTraceHandle();
     
+    Super::EndPlay(EndPlayReason);
+}
+
+void UCompanionInteraction::SetCurrentInteractable(AActor* NewInteractable)
+{
     // If the interactable changed, trigger the delegate
     if (NewInteractable != CurrentInteractable.Get())
     {
@@ -52,39 +68,61 @@ void UCompanionInteraction::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>
     // If we add replicated properties later, add them here
 }
 
-AActor* UCompanionInteraction::FindBestInteractable()
+void UCompanionInteraction::RequestInteractionSweep()
 {
     ACharacter* OwnerCharacter = Cast<ACharacter>(GetOwner());
     if (!OwnerCharacter)
     {
-        return nullptr;
+        SetCurrentInteractable(nullptr);
+        return;
     }
     
     // Get owner's location and forward vector
-    FVector Location = OwnerCharacter->GetActorLocation();
-    FVector Forward = OwnerCharacter->GetActorForwardVector();
+    const FVector Location = OwnerCharacter->GetActorLocation();
+    const FVector Forward = OwnerCharacter->GetActorForwardVector();
     
     // Do a sphere trace to find potential interactables
-    TArray<FHitResult> HitResults;
     FCollisionQueryParams QueryParams;
     QueryParams.AddIgnoredActor(GetOwner());
     
-    GetWorld()->SweepMultiByChannel(
-        HitResults,
+    if (!SweepDelegate.IsBound())
+    {
+        SweepDelegate.BindUObject(this, &UCompanionInteraction::OnInteractionSweepDone);
+    }
+    
+    PendingSweep = GetWorld()->AsyncSweepByChannel(
+        EAsyncTraceType::Multi,
         Location,
         Location + Forward * 10.0f, // Just to make it a minimal sweep
         FQuat::Identity,
         ECC_Visibility,
         FCollisionShape::MakeSphere(InteractionRange),
-        QueryParams
+        QueryParams,
+        FCollisionResponseParams::DefaultResponseParam,
+        &SweepDelegate
     );
+}
+
+void UCompanionInteraction::OnInteractionSweepDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    // Ignore a sweep we stopped waiting for
+    if (Handle != PendingSweep)
+    {
+        return;
+    }
+    PendingSweep = FTraceHandle();
     
     // Debug visualization
     if (bShowDebugTraces)
     {
-        DrawDebugSphere(GetWorld(), Location, InteractionRange, 12, FColor::Green, false, -1.0f, 0, 1.0f);
+        DrawDebugSphere(GetWorld(), Datum.Start, InteractionRange, 12, FColor::Green, false, -1.0f, 0, 1.0f);
     }
     
+    SetCurrentInteractable(FindBestInteractable(Datum.Start, Datum.OutHits));
+}
+
+AActor* UCompanionInteraction::FindBestInteractable(const FVector& Location, const TArray<FHitResult>& HitResults) const
+{
     // Find the closest interactable that implements our interface
     AActor* ClosestInteractable = nullptr;
     float ClosestDistance = FLT_MAX;
@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionCore/CoreData/CompanionBlackboardDefaults.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardKeys.h"
+
+namespace
+{
+    template<typename TKeyType>
+    void BakeKey(FCompanionBlackboardSnapshot& Values, const UBlackboardData& Asset, const TCompanionBlackboardKey<TKeyType>& Key, typename TKeyType::FDataType Value)
+    {
+        if (Key.IsValid())
+        {
+            Values.SetValue<TKeyType>(Asset, Key.ID, Value);
+        }
+    }
+}
+
+const FCompanionBlackboardSnapshot& UCompanionBlackboardDefaults::GetBakedValues(const UBlackboardData& BlackboardAsset) const
+{
+    check(IsInGameThread());
+
+    if (const FCompanionBlackboardSnapshot* Existing = BakedValues.Find(&BlackboardAsset))
+    {
+        return *Existing;
+    }
+
+    FCompanionBlackboardSnapshot& Values = BakedValues.Add(&BlackboardAsset);
+    Bake(BlackboardAsset, Values);
+    return Values;
+}
+
+void UCompanionBlackboardDefaults::Bake(const UBlackboardData& BlackboardAsset, FCompanionBlackboardSnapshot& OutValues) const
+{
+    const FCompanionBlackboardKeys& Keys = FCompanionBlackboardKeys::Get(&BlackboardAsset);
+
+    // Utility scores
+    BakeKey(OutValues, BlackboardAsset, Keys.IdleScore,          IdleScore);
+    BakeKey(OutValues, BlackboardAsset, Keys.FollowScore,        FollowScore);
+    BakeKey(OutValues, BlackboardAsset, Keys.PatrolScore,        PatrolScore);
+    BakeKey(OutValues, BlackboardAsset, Keys.GatherScore,        GatherScore);
+    BakeKey(OutValues, BlackboardAsset, Keys.CombatScore,        CombatScore);
+
+    // Task and awareness states start cleared
+    BakeKey(OutValues, BlackboardAsset, Keys.IsTaskActive,       false);
+    BakeKey(OutValues, BlackboardAsset, Keys.IsFollowing,        false);
+    BakeKey(OutValues, BlackboardAsset, Keys.IsPatrolling,       false);
+    BakeKey(OutValues, BlackboardAsset, Keys.IsGathering,        false);
+    BakeKey(OutValues, BlackboardAsset, Keys.HasValidTarget,     false);
+    BakeKey(OutValues, BlackboardAsset, Keys.IsOwnerInDanger,    false);
+    BakeKey(OutValues, BlackboardAsset, Keys.IsSelfInDanger,     false);
+    BakeKey(OutValues, BlackboardAsset, Keys.IsResourceDetected, false);
+    BakeKey(OutValues, BlackboardAsset, Keys.IsThreatDetected,   false);
+    BakeKey(OutValues, BlackboardAsset, Keys.CurrentTaskType,    static_cast<uint8>(InitialTask));
+
+    // Survival
+    BakeKey(OutValues, BlackboardAsset, Keys.InventorySpace,     InventorySpace);
+    BakeKey(OutValues, BlackboardAsset, Keys.ResourceAmount,     ResourceAmount);
+    BakeKey(OutValues, BlackboardAsset, Keys.OwnerProximity,     0.0f);
+    BakeKey(OutValues, BlackboardAsset, Keys.CurrentStamina,     CurrentStamina);
+    BakeKey(OutValues, BlackboardAsset, Keys.MaxStamina,         MaxStamina);
+}
+
+void UCompanionBlackboardDefaults::PostInitProperties()
+{
+    Super::PostInitProperties();
+
+    // The class default object included: controllers without BlackboardDefaults bake through it
+    UBlackboardData::OnUpdateKeys.AddUObject(this, &UCompanionBlackboardDefaults::HandleKeysUpdated);
+}
+
+void UCompanionBlackboardDefaults::BeginDestroy()
+{
+    UBlackboardData::OnUpdateKeys.RemoveAll(this);
+
+    Super::BeginDestroy();
+}
+
+void UCompanionBlackboardDefaults::HandleKeysUpdated(UBlackboardData* Asset)
+{
+    // Re-bake against the new key layout on next use
+    if (Asset)
+    {
+        BakedValues.Remove(Asset);
+    }
+}
+
+#if WITH_EDITOR
+void UCompanionBlackboardDefaults::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    // Re-bake with the new values on next use
+    BakedValues.Reset();
+}
+#endif
@@ -0,0 +1,92 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionCore/CoreData/CompanionPerceptionProfile.h"
+#include "Perception/AISenseConfig_Sight.h"
+#include "Perception/AISenseConfig_Hearing.h"
+#include "Engine/World.h"
+#include "UObject/Package.h"
+
+void UCompanionPerceptionProfile::PostInitProperties()
+{
+    Super::PostInitProperties();
+
+    // The class default object included: controllers without a profile share configs through it
+    FWorldDelegates::OnWorldCleanup.AddUObject(this, &UCompanionPerceptionProfile::HandleWorldCleanup);
+}
+
+void UCompanionPerceptionProfile::BeginDestroy()
+{
+    FWorldDelegates::OnWorldCleanup.RemoveAll(this);
+
+    Super::BeginDestroy();
+}
+
+void UCompanionPerceptionProfile::HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+    // Configs are runtime objects of the worlds that used them; don't carry them into the next session.
+    // Controllers still holding one keep it alive through their own reference until they go away.
+    if (World && World->IsGameWorld())
+    {
+        SightConfigs.Reset();
+        HearingConfigs.Reset();
+    }
+}
+
+int32 UCompanionPerceptionProfile::QuantizeRadius(float Radius) const
+{
+    return FMath::Max(FMath::RoundToInt32(Radius / RadiusQuantization), 0);
+}
+
+UAISenseConfig_Sight* UCompanionPerceptionProfile::GetSightConfig(float Radius, float HalfAngleDegrees) const
+{
+    check(IsInGameThread());
+
+    const int32 RadiusSteps = QuantizeRadius(Radius);
+    const int32 Angle = FMath::Clamp(FMath::RoundToInt32(HalfAngleDegrees), 0, 180);
+    const uint64 Key = (uint64(RadiusSteps) << 32) | uint64(Angle);
+
+    TObjectPtr<UAISenseConfig_Sight>& Config = SightConfigs.FindOrAdd(Key);
+    if (!Config)
+    {
+        Config = NewObject<UAISenseConfig_Sight>(GetTransientPackage());
+        Config->SightRadius = RadiusSteps * RadiusQuantization;
+        Config->LoseSightRadius = Config->SightRadius + LoseSightRadiusOffset;
+        Config->PeripheralVisionAngleDegrees = Angle;
+        Config->SetMaxAge(SightMaxAge);
+        Config->AutoSuccessRangeFromLastSeenLocation = AutoSuccessRangeFromLastSeenLocation;
+        Config->DetectionByAffiliation.bDetectEnemies = bDetectEnemies;
+        Config->DetectionByAffiliation.bDetectFriendlies = bDetectFriendlies;
+        Config->DetectionByAffiliation.bDetectNeutrals = bDetectNeutrals;
+    }
+    return Config;
+}
+
+UAISenseConfig_Hearing* UCompanionPerceptionProfile::GetHearingConfig(float Range) const
+{
+    check(IsInGameThread());
+
+    const int32 RangeSteps = QuantizeRadius(Range);
+
+    TObjectPtr<UAISenseConfig_Hearing>& Config = HearingConfigs.FindOrAdd(RangeSteps);
+    if (!Config)
+    {
+        Config = NewObject<UAISenseConfig_Hearing>(GetTransientPackage());
+        Config->HearingRange = RangeSteps * RadiusQuantization;
+        Config->SetMaxAge(HearingMaxAge);
+        Config->DetectionByAffiliation.bDetectEnemies = bDetectEnemies;
+        Config->DetectionByAffiliation.bDetectFriendlies = bDetectFriendlies;
+        Config->DetectionByAffiliation.bDetectNeutrals = bDetectNeutrals;
+    }
+    return Config;
+}
+
+#if WITH_EDITOR
+void UCompanionPerceptionProfile::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    // Controllers pick up configs with the new values on their next perception update
+    SightConfigs.Reset();
+    HearingConfigs.Reset();
+}
+#endif
@@ -5,6 +5,7 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
 #include "CompanionAI/CompanionControllers/AICompanionController.h"
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardKeys.h"
 
 UCompanionTaskAsset::UCompanionTaskAsset()
 {
@@ -37,6 +38,8 @@ float UCompanionTaskAsset::CalculateTaskUtility(UBlackboardComponent* Blackboard
         return 0.0f;
     }
     
+    const FCompanionBlackboardKeys& Keys = FCompanionBlackboardKeys::Get(*Blackboard);
+    
     // Start with base score
     float Score = TaskData.BaseScore * UtilityScoreMultiplier;
     
@@ -45,7 +48,7 @@ float UCompanionTaskAsset::CalculateTaskUtility(UBlackboardComponent* Blackboard
     {
         case ECompanionTask::Idle:
             // Idle is more useful when character is tired
-            if (Blackboard->GetValueAsFloat(FName("CurrentStamina")) < Blackboard->GetValueAsFloat(FName("MaxStamina")) * 0.5f)
+            if (Keys.CurrentStamina.Get(Blackboard) < Keys.MaxStamina.Get(Blackboard) * 0.5f)
             {
                 Score += 0.3f;
             }
@@ -54,14 +57,14 @@ float UCompanionTaskAsset::CalculateTaskUtility(UBlackboardComponent* Blackboard
         case ECompanionTask::Follow:
             // Follow is more useful when far from player
             {
-                float Distance = Blackboard->GetValueAsFloat(FName("OwnerDistance"));
+                float Distance = Keys.OwnerDistance.Get(Blackboard);
                 Score += FMath::Clamp(Distance / 1000.0f, 0.0f, 0.5f);
             }
             break;
             
         case ECompanionTask::Patrol:
             // Patrol is more useful when no threats detected
-            if (!Blackboard->GetValueAsBool(FName("IsThreatDetected")))
+            if (!Keys.IsThreatDetected.Get(Blackboard))
             {
                 Score += 0.2f;
             }
@@ -69,7 +72,7 @@ float UCompanionTaskAsset::CalculateTaskUtility(UBlackboardComponent* Blackboard
             
         case ECompanionTask::Gather:
             // Gather is more useful when resources detected
-            if (Blackboard->GetValueAsBool(FName("IsResourceDetected")))
+            if (Keys.IsResourceDetected.Get(Blackboard))
             {
                 Score += 0.3f;
             }
@@ -77,7 +80,7 @@ float UCompanionTaskAsset::CalculateTaskUtility(UBlackboardComponent* Blackboard
             
         case ECompanionTask::Search:
             // Search is more useful in unexplored areas
-            if (Blackboard->GetValueAsFloat(FName("ExplorationPercentage")) < 0.5f)
+            if (Keys.ExplorationPercentage.Get(Blackboard) < 0.5f)
             {
                 Score += 0.25f;
             }
@@ -116,14 +119,14 @@ bool UCompanionTaskAsset::AreRequirementsMet(UBlackboardComponent* Blackboard) c
         
         if (KeyType == UBlackboardKeyType_Vector::StaticClass())
         {
-            if (!Blackboard->IsVectorValueSet(KeyName))
+            if (!Blackboard->IsVectorValueSet(KeyID))
             {
                 return false;
             }
         }
         else if (KeyType == UBlackboardKeyType_Object::StaticClass())
         {
-            if (Blackboard->GetValueAsObject(KeyName) == nullptr)
+            if (Blackboard->GetValue<UBlackboardKeyType_Object>(KeyID) == nullptr)
             {
                 return false;
             }
@@ -0,0 +1,10 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CompanionCore/CoreTags/CompanionGameplayTags.h"
+
+namespace CompanionTags
+{
+    UE_DEFINE_GAMEPLAY_TAG_COMMENT(Stimulus,          "Ikarus.Stimulus",          "Perception stimulus categories handled by companions");
+    UE_DEFINE_GAMEPLAY_TAG_COMMENT(Stimulus_Threat,   "Ikarus.Stimulus.Threat",   "Hostile actor or danger the companion should react to");
+    UE_DEFINE_GAMEPLAY_TAG_COMMENT(Stimulus_Resource, "Ikarus.Stimulus.Resource", "Gatherable resource");
+}
@@ -6,6 +6,28 @@
 #include "BehaviorTree/BTService.h"
 #include "UpdatePlayerLocation.generated.h"
 
+/** Per-instance state of UUpdatePlayerLocation */
+struct FUpdatePlayerLocationMemory
+{
+	/** Last location written to the blackboard */
+	FVector LastWritten = FVector::ZeroVector;
+
+	/** Unclipped prediction behind the last write; drift is measured against this, not the navmesh-clipped point */
+	FVector LastPredicted = FVector::ZeroVector;
+
+	/** Player found without the actor key, kept until it goes away */
+	TWeakObjectPtr<AActor> CachedPlayer;
+
+	/** Player velocity at the previous tick, for the acceleration estimate */
+	FVector LastVelocity = FVector::ZeroVector;
+
+	/** Smoothed player acceleration */
+	FVector Acceleration = FVector::ZeroVector;
+
+	/** World time of the previous velocity sample (negative before the first) */
+	double LastSampleTime = -1.0;
+};
+
 /**
  * 
  */
@@ -32,6 +54,22 @@ public:
 	UPROPERTY(EditAnywhere, Category="Performance", meta=(ClampMin="1"))
 	float MoveThreshold = 15.f;
 
+	/** Write where the player is heading instead of where they are, so followers repath less while the player runs. */
+	UPROPERTY(EditAnywhere, Category="Prediction")
+	bool bPredictTarget = false;
+
+	/** How far ahead (seconds) the player's position is extrapolated from velocity and acceleration. */
+	UPROPERTY(EditAnywhere, Category="Prediction", meta=(EditCondition="bPredictTarget", ClampMin="0", ClampMax="3"))
+	float PredictionHorizon = 0.5f;
+
+	/** The prediction never leads the player by more than this (cm). */
+	UPROPERTY(EditAnywhere, Category="Prediction", meta=(EditCondition="bPredictTarget", ClampMin="0"))
+	float MaxPredictionDistance = 600.f;
+
+	/** Prediction must drift this far (cm) from the written target before the key is rewritten. */
+	UPROPERTY(EditAnywhere, Category="Prediction", meta=(EditCondition="bPredictTarget", ClampMin="1"))
+	float PredictionErrorThreshold = 120.f;
+
 	/** Hard distance cap – outside this the service does no work. */
 	UPROPERTY(EditAnywhere, Category="Performance", meta=(ClampMin="10"))
 	float MaxFollowRange = 8000.f;
@@ -49,6 +87,13 @@ public:
 	void TickNode(UBehaviorTreeComponent& OwnerComp,
 				  uint8* NodeMemory,
 				  float DeltaSeconds) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+
+protected:
+	/** Stretch the tick interval by the companion's AI LOD service scale */
+	virtual void ScheduleNextTick(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
 
 private:
 	/* Cached blackboard key IDs (filled in InitializeFromAsset) */
@@ -58,7 +103,6 @@ private:
 	/* MoveThreshold squared – avoids FMath::Square each tick */
 	float MoveThresholdSq = 225.f;            /* 15 cm² default */
 
-	/* Local cache of last location and player pointer */
-	FVector               LastWritten = FVector::ZeroVector;
-	TWeakObjectPtr<AActor> CachedPlayer;
+	/* Extrapolate the player's location over PredictionHorizon (not yet clamped to the navmesh) */
+	FVector PredictLocation(const AActor& Player, FUpdatePlayerLocationMemory& Memory, double Now) const;
 };
@@ -4,9 +4,43 @@
 
 #include "CoreMinimal.h"
 #include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
+#include "WorldCollision.h"
 #include "CompanionCore/CoreEnums/CompanionEnums.h"
 #include "FindPlayerLocation.generated.h"
 
+class UNavigationSystemV1;
+class FCompanionVisitedGrid;
+
+/** One running nearby-location search, shared with the queued work item and async trace callbacks */
+struct FFindPlayerLocationSearch
+{
+	TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp;
+	
+	TWeakObjectPtr<AActor> Player;
+	
+	/** Candidates in the order they are validated */
+	TArray<FVector> Candidates;
+	
+	/** Async line-of-sight result per candidate */
+	TBitArray<> Blocked;
+	
+	/** Async traces still to report back */
+	int32 PendingTraces = 0;
+};
+
+/** Per-instance state of UFindPlayerLocation */
+struct FFindPlayerLocationMemory
+{
+	/** Queued nearby-location search in UCompanionWorldSubsystem (0 when none) */
+	uint32 WorkHandle = 0;
+	
+	/** Running search; callbacks only hold weak references, so resetting it (abort, finish, cleanup) cancels them */
+	TSharedPtr<FFindPlayerLocationSearch> Search;
+	
+	/** The last run committed a claimed follow slot, which stays claimed while the companion heads there */
+	bool bUsedFollowSlot = false;
+};
+
 /**
  * Behavior Tree Task that locates the player or finds a position near them
  * based on configurable parameters.
@@ -19,6 +53,11 @@ class IKARUSTHECOMPANION_API UFindPlayerLocation : public UBTTask_BlackboardBase
 public:
 	explicit UFindPlayerLocation(FObjectInitializer const& ObjectInitializer);
 	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
 
 	protected:
 	// Core Parameters
@@ -45,12 +84,28 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Task|Positioning", meta = (EditCondition = "UseDirectionalBias"))
 	EPositioningPreference DirectionalPreference;  // Direction preference relative to player
 
+	UPROPERTY(EditAnywhere, Category = "Task|Positioning", meta = (EditCondition = "!UseExactLocation"))
+	bool UseFollowSlots;  // Claim a shared follow slot around the player before searching on our own
+
+	// Batched Search Parameters
+	UPROPERTY(EditAnywhere, Category = "Task|Search", meta = (EditCondition = "!UseExactLocation"))
+	bool UseBatchedSearch;  // Generate and score a batch of candidates instead of sequential random attempts
+
+	UPROPERTY(EditAnywhere, Category = "Task|Search", meta = (EditCondition = "UseBatchedSearch", ClampMin = "1", ClampMax = "32"))
+	int32 CandidateCount;  // Candidates generated per search (upper bound on nav projections and traces)
+
+	UPROPERTY(EditAnywhere, Category = "Task|Search", meta = (EditCondition = "UseBatchedSearch", ClampMin = "0.0"))
+	float DistanceWeight;  // Score weight of being close to the player (beyond the minimum distance)
+
+	UPROPERTY(EditAnywhere, Category = "Task|Search", meta = (EditCondition = "UseBatchedSearch", ClampMin = "0.0"))
+	float DirectionWeight;  // Score weight of matching the directional preference
+
+	UPROPERTY(EditAnywhere, Category = "Task|Search", meta = (EditCondition = "UseBatchedSearch", ClampMin = "0.0"))
+	float NoveltyWeight;  // Score weight of being away from previously used locations
+
 	// Advanced Parameters
 	UPROPERTY(EditAnywhere, Category = "Task|Advanced")
-	bool AvoidPreviousLocations;  // Avoid previously selected points
-
-	UPROPERTY(EditAnywhere, Category = "Task|Advanced", meta = (EditCondition = "AvoidPreviousLocations", ClampMin = "0"))
-	int32 LocationMemorySize;  // How many previous locations to remember
+	bool AvoidPreviousLocations;  // Avoid points this player's companions used recently (shared visited grid)
 
 	// Debug Parameters
 	UPROPERTY(EditAnywhere, Category = "Task|Debug")
@@ -60,14 +115,44 @@ public:
 	float DebugDuration;  // How long to show debug visuals
 
 private:
-	// Stores previously used locations when AvoidPreviousLocations is true
-	TArray<FVector> PreviousLocations;
-
-	// Helper function to check if a potential location has been used recently
-	bool HasLocationBeenUsedRecently(const FVector& Location) const;
+	// Visited grid shared by the player's companions; null when AvoidPreviousLocations is off or there is no companion subsystem
+	FCompanionVisitedGrid* FindVisitedGrid(AActor* PlayerActor) const;
+	
+	// Collect candidate locations near the player, in the order they should be validated
+	bool GatherCandidates(AActor* PlayerActor, TArray<FVector>& OutCandidates);
+	
+	// Sequential random points around the player that pass the cheap filters
+	void GatherRandomCandidates(AActor* PlayerActor, UNavigationSystemV1& NavSys, TArray<FVector>& OutCandidates) const;
+	
+	// Batched variant: generate candidates in one pass, filter cheap criteria and sort by score
+	void GatherScoredCandidates(AActor* PlayerActor, UNavigationSystemV1& NavSys, TArray<FVector>& OutCandidates) const;
+	
+	// Run a queued search: gather candidates, then trace them or finish right away
+	void RunSearch(const TSharedRef<FFindPlayerLocationSearch>& Search);
+	
+	// Issue one async line-of-sight trace per candidate; the search finishes when the last one reports back
+	void RequestLineOfSightTraces(const TSharedRef<FFindPlayerLocationSearch>& Search);
+	
+	// Pick from the gathered candidates, commit the result and finish the latent task
+	void FinishSearch(FFindPlayerLocationSearch& Search);
+	
+	// First candidate with line of sight (from Blocked, or traced now when null) and a path to the player
+	bool PickCandidate(AActor* PlayerActor, TConstArrayView<FVector> Candidates, const TBitArray<>* Blocked, FVector& OutLocation);
+	
+	// Expensive checks of one candidate: line of sight (known result, or traced now when null) and a path to the player
+	bool PassesExpensiveChecks(AActor* PlayerActor, const FVector& Candidate, const bool* bKnownBlocked) const;
+	
+	// Whether a shared follow slot satisfies this node's distance, direction, reachability and sight constraints
+	bool IsFollowSlotUsable(AActor* PlayerActor, const FVector& SlotLocation) const;
+	
+	// Preferred direction on the ground plane, or zero when there is none
+	FVector GetPreferredDirection(AActor* PlayerActor) const;
+	
+	// Mark a chosen location in the player's visited grid when AvoidPreviousLocations is true
+	void RememberLocation(AActor* PlayerActor, const FVector& Location) const;
 	
-	// Helper function to find a valid location near the player
-	bool FindNearbyLocation(AActor* PlayerActor, FVector& OutLocation);
+	// Write the chosen location to the blackboard key
+	void CommitLocation(UBehaviorTreeComponent& OwnerComp, const FVector& Location) const;
 	
 	// Apply directional bias to candidate location
 	FVector ApplyDirectionalBias(AActor* PlayerActor, const FVector& OriginLocation, float Distance) const;
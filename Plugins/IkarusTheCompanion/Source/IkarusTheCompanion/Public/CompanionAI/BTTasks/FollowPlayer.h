@@ -8,6 +8,52 @@
 #include "NavFilters/NavigationQueryFilter.h"
 #include "FollowPlayer.generated.h"
 
+class AAIController;
+
+/** Async path query of UFollowPlayer; its completion callback only reaches it through a weak pointer */
+struct FFollowPlayerPathQuery
+{
+	uint32 QueryID = INVALID_NAVQUERYID;
+	
+	/** Goal the path was requested towards */
+	FVector Goal = FVector::ZeroVector;
+	
+	/** Result landed; picked up on the next task tick */
+	bool bFinished = false;
+	
+	ENavigationQueryResult::Type Result = ENavigationQueryResult::Invalid;
+	
+	FNavPathSharedPtr Path;
+};
+
+/** Per-instance state of UFollowPlayer */
+struct FFollowPlayerMemory
+{
+	/** Latest target a move or path query was issued towards */
+	FVector CachedTarget = FVector::ZeroVector;
+	
+	/** Goal of the move being followed; lags CachedTarget while an async path query is in flight */
+	FVector MoveGoal = FVector::ZeroVector;
+	
+	/** Move we are waiting on (invalid when none) */
+	FAIRequestID MoveRequestID;
+	
+	/** Time since the last repath check (throttled by the companion's AI LOD) */
+	float TimeSinceRepathCheck = 0.f;
+	
+	/** Async path query in flight (null when none); the current path is followed until it lands */
+	TSharedPtr<FFollowPlayerPathQuery> PathQuery;
+	
+	/** Path failures in a row, driving the backoff */
+	int32 ConsecutiveFailures = 0;
+	
+	/** World time before which this companion does not path again after failures */
+	double RetryAfter = 0.0;
+	
+	/** In progress without a move, waiting for the backoff or an unreachable goal to clear */
+	bool bWaitingToRetry = false;
+};
+
 /**
  * 
  */
@@ -23,6 +69,10 @@ class IKARUSTHECOMPANION_API UFollowPlayer : public UBTTask_BlackboardBase
 	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
 	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
 	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnMessage(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, FName Message, int32 RequestID, bool bSuccess) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
 	virtual void OnGameplayTaskActivated(UGameplayTask& Task) override {}
 
 
@@ -45,18 +95,53 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Follow")
 	float RepathThreshold = 150.f;
 
+	/** Re-plan with async path queries, following the current path until the new one arrives. */
+	UPROPERTY(EditAnywhere, Category="Follow|Repath")
+	bool bAsyncRepath = true;
+
+	/** Goal shifts up to this far (cm) are spliced onto the current path when a straight navmesh segment reaches them. */
+	UPROPERTY(EditAnywhere, Category="Follow|Repath", meta=(EditCondition="bAsyncRepath", ClampMin="0"))
+	float SpliceDistance = 400.f;
+
+	/** Seconds this companion waits before pathing again after a failure; doubles with each failure in a row. */
+	UPROPERTY(EditAnywhere, Category="Follow|Backoff", meta=(ClampMin="0"))
+	float FailureBackoff = 0.5f;
+
+	/** Longest wait (seconds) between path attempts after repeated failures. */
+	UPROPERTY(EditAnywhere, Category="Follow|Backoff", meta=(ClampMin="0"))
+	float MaxFailureBackoff = 8.f;
+
 private:
-	FVector CachedTarget = FVector::ZeroVector;
-	
-	// Track current move request
-	FAIRequestID CurrentMoveRequestID;
-	bool bIsMoveActive = false;
+	/** Move request towards Goal with the designer settings */
+	FAIMoveRequest MakeMoveRequest(const FVector& Goal) const;
 
-	/* — delegate — */
-	UFUNCTION()
-	void HandleMoveFinished(FAIRequestID RequestID, EPathFollowingResult::Type Result);
-	
-	// Helper functions
-	bool StartMoveRequest(AAIController* Controller, const FVector& Target);
-	void CleanupDelegates(AAIController* Controller);
+	/** Issue a move towards Memory.CachedTarget and wait for its completion message */
+	EBTNodeResult::Type RequestMove(UBehaviorTreeComponent& OwnerComp, AAIController& Controller, FFollowPlayerMemory& Memory) const;
+
+	/** Move the end of the path being followed to NewTarget when a straight navmesh segment reaches it */
+	bool TrySplicePath(AAIController& Controller, const FFollowPlayerMemory& Memory, const FVector& NewTarget) const;
+
+	/** Start an async path query towards NewTarget; the result replaces the current path on the tick after it arrives */
+	bool RequestPathAsync(UBehaviorTreeComponent& OwnerComp, AAIController& Controller, FFollowPlayerMemory& Memory, const FVector& NewTarget) const;
+
+	/** Switch the move over to a path found by RequestPathAsync */
+	void OnPathFound(UBehaviorTreeComponent& OwnerComp, FFollowPlayerMemory& Memory, const FFollowPlayerPathQuery& PathQuery) const;
+
+	/** Whether pathing towards Goal should be skipped: in backoff, or a known unreachable destination */
+	bool ShouldSkipPath(UBehaviorTreeComponent& OwnerComp, const FFollowPlayerMemory& Memory, const FVector& Goal) const;
+
+	/**
+	 * Whether a move that finished unsuccessfully really failed (blocked, off path, invalid) rather than being aborted.
+	 * bOutGoalUnreachable is set only when the path itself was invalid, not when this companion got stuck on the way.
+	 */
+	bool IsMoveFailure(UBehaviorTreeComponent& OwnerComp, int32 RequestID, bool& bOutGoalUnreachable) const;
+
+	/** Record a failed path towards Goal: this companion's backoff, plus the shared unreachable cache when the goal itself could not be pathed to */
+	void NotePathFailed(UBehaviorTreeComponent& OwnerComp, FFollowPlayerMemory& Memory, const FVector& Goal, bool bGoalUnreachable) const;
+
+	/** Record a successful path towards Goal: clears the backoff and the goal's unreachable mark */
+	void NotePathSucceeded(UBehaviorTreeComponent& OwnerComp, FFollowPlayerMemory& Memory, const FVector& Goal) const;
+
+	/** Drop the async path query, cancelling it if still in flight */
+	void AbortPathQuery(UBehaviorTreeComponent& OwnerComp, FFollowPlayerMemory& Memory) const;
 };
@@ -21,6 +21,9 @@ class IKARUSTHECOMPANION_API USetMovementSpeed : public UBTTask_BlackboardBase
 	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp,
 											uint8* NodeMemory) override;
 
+	/** Resolve the extra key selectors to IDs once per tree asset */
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+
 protected:
 	UPROPERTY(EditAnywhere, Category="Speed")
 	ECompanionMovementSpeed CompanionSpeed = ECompanionMovementSpeed::Walking;
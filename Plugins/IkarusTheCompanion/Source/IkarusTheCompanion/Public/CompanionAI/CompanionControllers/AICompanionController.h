@@ -5,9 +5,20 @@
 #include "CoreMinimal.h"
 #include "AIController.h"
 #include "Perception/AIPerceptionTypes.h"
+#include "UObject/ObjectKey.h"
+#include "CompanionCore/CoreEnums/CompanionEnums.h"
+#include "CompanionCore/CoreStructs/CompanionCoreStructs.h"
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardKeys.h"
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardSnapshot.h"
+#include "CompanionAI/Perception/CompanionStimulusHistory.h"
+#include "CompanionAI/Perception/CompanionThreatTracker.h"
 #include "AICompanionController.generated.h"
 
 class UBehaviorTreeComponent;
+class UCompanionBlackboardDefaults;
+class UCompanionPerceptionProfile;
+class UAISenseConfig_Sight;
+class UAISenseConfig_Hearing;
 
 
 /**
@@ -31,6 +42,15 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	UBehaviorTreeComponent* GetBehaviorTreeComponent() const { return BehaviorTreeComponent; }
 	
+	/** Typed key IDs for the current blackboard asset (all invalid before the blackboard is initialized) */
+	const FCompanionBlackboardKeys& GetBlackboardKeys() const { return *BlackboardKeys; }
+	
+	/** Writes queued for this frame; applied together by the world subsystem or FlushBlackboardWrites */
+	FCompanionBlackboardWriteBuffer& GetBlackboardWriteBuffer() { return BlackboardWrites; }
+	
+	/** Apply queued blackboard writes now, with one observer notification per changed key */
+	void FlushBlackboardWrites();
+	
 	/** Set the owner player for this companion (multiplayer support) */
 	UFUNCTION(BlueprintCallable, Category = "AI|Multiplayer")
 	void SetOwnerPlayer(ACharacter* NewOwnerPlayer);
@@ -43,6 +63,28 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AI|Perception")
 	void UpdateThreatAwareness();
 	
+	/** Threats near the companion from the last threat awareness update, nearest first */
+	UFUNCTION(BlueprintCallable, Category = "AI|Perception")
+	const TArray<FCompanionThreatInfo>& GetRankedThreats() const { return RankedThreats; }
+	
+	/** Pawns around the companion from the last social awareness update */
+	UFUNCTION(BlueprintCallable, Category = "AI|Social")
+	const FCompanionNeighbourSummary& GetNeighbourSummary() const { return NeighbourSummary; }
+	
+	/** Threat the companion has settled on (changes only when another one clearly outscores it) */
+	UFUNCTION(BlueprintCallable, Category = "AI|Perception")
+	AActor* GetCurrentThreat() const { return ThreatTracker.GetTarget(); }
+	
+	/** Scored threats this companion is tracking */
+	const FCompanionThreatTracker& GetThreatTracker() const { return ThreatTracker; }
+	
+	/** Recent perception events, indexed by actor and sense */
+	const FCompanionStimulusHistory& GetStimulusHistory() const { return StimulusHistory; }
+	
+	/** Perception values currently applied (debug) */
+	UFUNCTION(BlueprintCallable, Category = "AI|Debug")
+	const FCompanionPerceptionSettings& GetPerceptionSettings() const { return PerceptionSettings; }
+	
 	/** Force update all blackboard values related to owner and state */
 	UFUNCTION(BlueprintCallable, Category = "AI|Multiplayer")
 	void ForceUpdateBlackboardValues();
@@ -54,6 +96,42 @@ public:
     /** Log details about the companion's current task and behavior */
     UFUNCTION(BlueprintCallable, Category = "AI|Debug")
     void LogCompanionStatus(const FString& Context);
+	
+	/** Current AI level-of-detail bucket */
+	UFUNCTION(BlueprintCallable, Category="AI|Performance")
+	ECompanionAILOD GetAILOD() const { return CurrentAILOD; }
+	
+	/** Settings of the current AI level-of-detail bucket */
+	const FCompanionAILODSettings& GetAILODSettings() const;
+	
+	/** Pick the LOD bucket for the given significance distance (distance to the most relevant player) */
+	void UpdateAILOD(float SignificanceDistance);
+	
+	/** React to a player command: wakes from hibernation, and "Stay" schedules the next one */
+	void HandleCommand(FName CommandName);
+	
+	/** Whether the companion is parked with BT, movement and blackboard updates suspended */
+	UFUNCTION(BlueprintCallable, Category="AI|Performance")
+	bool IsHibernating() const { return bHibernating; }
+	
+	/** Leave hibernation and refresh state (proximity, perception stimulus or a new command) */
+	UFUNCTION(BlueprintCallable, Category="AI|Performance")
+	void WakeFromHibernation();
+	
+	/** Feed the owner distance while hibernating; wakes once the owner left and came back within the wake distance */
+	void UpdateHibernationOwnerDistance(float OwnerDistance);
+	
+	/** Whether the world subsystem may collapse this companion into a virtual record */
+	bool CanVirtualise() const;
+	
+	/** Whether the last command was "Stay" */
+	bool IsStayCommanded() const { return bStayCommanded; }
+	
+	/** Queue blackboard state, owner and "Stay" command to restore on the next possess (used when rehydrating a virtual companion) */
+	void PrepareRehydration(const FCompanionBlackboardSnapshot& Snapshot, ACharacter* InOwnerPlayer, bool bInStayCommanded);
+	
+	/** Full result of a finished move, if it was the last one; the move-finished BT message only carries success */
+	const FPathFollowingResult* FindMoveResult(FAIRequestID RequestID) const;
 
 protected:
 	/** Called every frame */
@@ -71,16 +149,29 @@ protected:
 	/** Handle replication setup for multiplayer */
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	
-	/** Update companion perception intensity based on environment and game state */
+	/**
+	 * Update companion perception intensity based on environment and game state:
+	 * AI LOD, current task, time of day and how crowded the surroundings are.
+	 * Senses are only reconfigured when the result actually changes.
+	 */
 	UFUNCTION(BlueprintNativeEvent, Category = "AI|Perception")
 	void UpdatePerceptionSettings();
 	virtual void UpdatePerceptionSettings_Implementation();
 	
+	/** Sight multiplier for the current time of day (1 = full daylight); override to hook up the game's day/night cycle */
+	UFUNCTION(BlueprintNativeEvent, Category = "AI|Perception")
+	float GetTimeOfDaySightScale() const;
+	virtual float GetTimeOfDaySightScale_Implementation() const { return 1.f; }
+	
 private:
 	/** Behavior tree asset to run */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="AI", meta=(AllowPrivateAccess="true"))
 	TObjectPtr<UBehaviorTree> BehaviorTree;
 
+	/** Starting blackboard values, baked per blackboard asset (class defaults are used when unset) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="AI", meta=(AllowPrivateAccess="true"))
+	TObjectPtr<UCompanionBlackboardDefaults> BlackboardDefaults;
+
 	/** Behavior tree component for executing logic */
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category="AI", meta=(AllowPrivateAccess="true"))
 	TObjectPtr<UBehaviorTreeComponent> BehaviorTreeComponent;
@@ -89,40 +180,220 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category="AI", meta=(AllowPrivateAccess="true"))
 	TObjectPtr<UBlackboardComponent> BlackboardComponent;
 	
+	/** Key IDs resolved for BlackboardComponent's asset, shared with every companion using that asset */
+	const FCompanionBlackboardKeys* BlackboardKeys = &FCompanionBlackboardKeys::Get(nullptr);
+	
+	/** Blackboard writes collected during the current frame */
+	FCompanionBlackboardWriteBuffer BlackboardWrites;
 	
 	/** The player character that owns this companion (replicated for multiplayer) */
 	UPROPERTY(Replicated, BlueprintReadOnly, Category="AI|Multiplayer", meta=(AllowPrivateAccess="true"))
 	TObjectPtr<ACharacter> OwnerPlayer;
 	
-	/** How often (in seconds) to update blackboard values */
+	/** How often (in seconds) the companion world subsystem refreshes this companion's blackboard */
 	UPROPERTY(EditDefaultsOnly, Category="AI|Performance", meta=(AllowPrivateAccess="true", ClampMin="0.1", ClampMax="1.0"))
-	float BlackboardUpdateInterval = 0.25f;
+	float BlackboardUpdateInterval = 0.1f;
 	
-	/** Timer handle for blackboard updates */
-	FTimerHandle BlackboardUpdateTimerHandle;
-
-	/** Time accumulator for optimized updates */
-	float UpdateTimeAccumulator = 0.0f;
+	/** Slot in UCompanionWorldSubsystem's batched arrays (INDEX_NONE when not registered) */
+	int32 WorldSlotIndex = INDEX_NONE;
+	
+	/** Tuning per AI LOD bucket, indexed by ECompanionAILOD (High, Medium, Low, Dormant) */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Performance", meta=(AllowPrivateAccess="true"))
+	TArray<FCompanionAILODSettings> AILODSettings;
+	
+	/** Fraction past a bucket's MaxDistance a companion must go before dropping to a lower bucket */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Performance", meta=(AllowPrivateAccess="true", ClampMin="0.0", ClampMax="0.5"))
+	float AILODHysteresis = 0.1f;
+	
+	/** Current AI LOD bucket */
+	UPROPERTY(VisibleInstanceOnly, Transient, Category="AI|Performance", meta=(AllowPrivateAccess="true"))
+	ECompanionAILOD CurrentAILOD = ECompanionAILOD::High;
+	
+	/**
+	 * Allow this companion to be virtualised after staying in the Dormant LOD bucket.
+	 * The pawn and controller are destroyed and respawned; only SaveGame properties and plain blackboard keys survive.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Performance", meta=(AllowPrivateAccess="true"))
+	bool bAllowVirtualisation = false;
+	
+	/** Seconds after a "Stay" command before the companion hibernates (negative disables hibernation) */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Performance", meta=(AllowPrivateAccess="true"))
+	float HibernateAfterStaySeconds = 3.f;
+	
+	/** A hibernating companion wakes when its owner comes this close */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Performance", meta=(AllowPrivateAccess="true", ClampMin="0.0"))
+	float HibernationWakeDistance = 600.f;
+	
+	/** Fraction beyond HibernationWakeDistance the owner must leave before coming back close wakes the companion */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Performance", meta=(AllowPrivateAccess="true", ClampMin="0.0"))
+	float HibernationWakeHysteresis = 0.25f;
+	
+	/** Currently hibernating */
+	UPROPERTY(VisibleInstanceOnly, Transient, Category="AI|Performance", meta=(AllowPrivateAccess="true"))
+	bool bHibernating = false;
+	
+	/** Last finished move, kept for FindMoveResult */
+	FAIRequestID LastMoveRequestID;
+	FPathFollowingResult LastMoveResult;
+	
+	/** Path following finished a move; runs before the move-finished message reaches the tree */
+	void RecordMoveResult(FAIRequestID RequestID, const FPathFollowingResult& Result);
+	
+	/** Pending transition into hibernation after a "Stay" command */
+	FTimerHandle HibernateTimerHandle;
+	
+	/** The last command was "Stay", so waking re-arms the hibernation timer */
+	bool bStayCommanded = false;
 	
-	/** Sight configuration for perception */
-	class UAISenseConfig_Sight* SightConfig;
+	/** The owner has been seen beyond the wake distance since hibernation began */
+	bool bOwnerWakeArmed = false;
 	
-	/** Sound configuration for perception */
-	class UAISenseConfig_Hearing* HearingConfig;
+	/** Suspend BT, movement and ticking; perception stays on as a wake trigger. Waits another round while busy. */
+	void EnterHibernation();
 	
-	/** Setup perception system components and configs */
+	/** Whether something still needs the companion awake: a tracked threat, danger, a move or a non-idle task */
+	bool IsBusyForHibernation() const;
+	
+	/** Start the hibernation timer if the companion is staying and none is pending */
+	void ScheduleHibernation();
+	
+	/** Sight of the owner or another companion, which does not wake a hibernating companion */
+	bool IsFamiliarSight(const AActor* Actor, const FAIStimulus& Stimulus) const;
+	
+	/** Pause or resume the behavior tree for whichever of AI LOD and hibernation wants it paused */
+	void RefreshBehaviorTreePause();
+	
+	/** Blackboard values waiting to be restored on possess */
+	FCompanionBlackboardSnapshot PendingBlackboardRestore;
+	
+	/** Owner waiting to be restored on possess */
+	TWeakObjectPtr<ACharacter> PendingOwnerRestore;
+	
+	/** Threats within this distance of the companion are tracked by threat awareness */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Perception", meta=(AllowPrivateAccess="true", ClampMin="0.0"))
+	float ThreatAwarenessRadius = 2000.f;
+	
+	/** A threat this close to the companion or its owner puts them in danger */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Perception", meta=(AllowPrivateAccess="true", ClampMin="0.0"))
+	float DangerRadius = 800.f;
+	
+	/** Most threats kept in the ranked threat list */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Perception", meta=(AllowPrivateAccess="true", ClampMin="1"))
+	int32 MaxTrackedThreats = 5;
+	
+	/** How tracked threats are prioritised */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Perception", meta=(AllowPrivateAccess="true"))
+	FCompanionThreatScoring ThreatScoring;
+	
+	/** Scored threats; its selected target is what ThreatActor holds */
+	FCompanionThreatTracker ThreatTracker;
+	
+	/** Nearest threats from the last threat awareness update */
+	UPROPERTY(VisibleInstanceOnly, Transient, Category="AI|Perception", meta=(AllowPrivateAccess="true"))
+	TArray<FCompanionThreatInfo> RankedThreats;
+	
+	/** Players, companions and NPCs within this distance count as neighbours for social awareness */
+	UPROPERTY(EditDefaultsOnly, Category="AI|Social", meta=(AllowPrivateAccess="true", ClampMin="0.0"))
+	float SocialAwarenessRadius = 1500.f;
+	
+	/** Neighbours from the last social awareness update */
+	UPROPERTY(VisibleInstanceOnly, Transient, Category="AI|Social", meta=(AllowPrivateAccess="true"))
+	FCompanionNeighbourSummary NeighbourSummary;
+	
+	/** Shared perception tuning and sense configs (class defaults are used when unset) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="AI|Perception", meta=(AllowPrivateAccess="true"))
+	TObjectPtr<UCompanionPerceptionProfile> PerceptionProfile;
+	
+	/** Values of this companion that differ from its perception profile */
+	UPROPERTY(EditAnywhere, Category="AI|Perception", meta=(AllowPrivateAccess="true"))
+	FCompanionPerceptionOverrides PerceptionOverrides;
+	
+	/** Perception values last applied to the senses */
+	UPROPERTY(VisibleInstanceOnly, Transient, Category="AI|Perception", meta=(AllowPrivateAccess="true"))
+	FCompanionPerceptionSettings PerceptionSettings;
+	
+	/** Apply the current LOD bucket to timers, movement, behavior tree and perception */
+	void ApplyAILOD();
+	
+	/** Sight config currently in use, shared with other companions through the perception profile */
+	UPROPERTY(Transient)
+	TObjectPtr<UAISenseConfig_Sight> SightConfig;
+	
+	/** Hearing config currently in use, shared with other companions through the perception profile */
+	UPROPERTY(Transient)
+	TObjectPtr<UAISenseConfig_Hearing> HearingConfig;
+	
+	/** Profile in use: PerceptionProfile, or the class defaults when unset */
+	const UCompanionPerceptionProfile& GetPerceptionProfile() const;
+	
+	/** Setup the perception component; senses are configured from the profile on possess */
 	void SetupPerceptionSystem();
 	
-	/** Handler for when target is detected by AI perception */
+	/** Handler for when target is detected by AI perception; queues the stimulus for the next batch */
 	UFUNCTION()
 	void OnTargetPerceptionUpdated(AActor* Actor, FAIStimulus const Stimulus);
 	
+	/** Latest queued stimulus of one actor */
+	struct FPendingStimulus
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FAIStimulus Stimulus;
+	};
+	
+	/** Stimuli received since the last batch, latest per actor */
+	TMap<TObjectKey<AActor>, FPendingStimulus> PendingStimuli;
+	
+	/** World time before which queued non-threat stimuli keep coalescing instead of being handled */
+	double NextStimulusBatchTime = 0.0;
+	
+	/** A threat-tagged stimulus is queued; it is handled on the next frame regardless of the batch interval */
+	bool bHasPendingThreat = false;
+	
+	/** Every stimulus received, kept for "when/where did I last sense X" queries */
+	FCompanionStimulusHistory StimulusHistory;
+	
+	/** Native handler for one stimulus tag */
+	using FStimulusHandler = void (AAICompanionController::*)(AActor*, const FAIStimulus&);
+	
+	/** Stimulus tag (Ikarus.Stimulus.* plus legacy names) to handler, built once */
+	static const TMap<FName, FStimulusHandler>& GetStimulusHandlers();
+	
+	/** Handle queued threat stimuli every frame and the rest at most once per SenseUpdateInterval (called by the world subsystem) */
+	void ProcessPendingStimuli();
+	
+	/** Track a threat stimulus and add the actor to the shared threat grid */
+	void HandleThreatStimulus(AActor* Actor, const FAIStimulus& Stimulus);
+	
+	/** Feed a sensed threat to the tracker and publish the target if it changed */
+	void ReportThreat(AActor* Threat, const FVector& Location);
+	
+	/** Whether the perception component currently senses the actor by any sense */
+	bool IsActorPerceived(const AActor* Actor) const;
+	
+	/** Write the tracker's selected target to the blackboard */
+	void WriteThreatTarget();
+	
+	/** Credit damage taken by the pawn to its instigator in the threat tracker */
+	UFUNCTION()
+	void OnPawnTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
+	
+	/** Write resource stimulus to the blackboard */
+	void HandleResourceStimulus(AActor* Actor, const FAIStimulus& Stimulus);
+	
 	/** Initialize our blackboard with companion-specific values */
 	void SetupCompanionBlackboardValues();
 	
 	/** Blackboard update function for optimized performance */
 	void UpdateBlackboardValues();
 	
+	/** Write owner/companion distance values computed by the world subsystem's batched pass */
+	void ApplyOwnerProximity(const FVector& CompanionLocation, const FVector& OwnerLocation, float OwnerDistance, float OwnerProximity, bool bHasOwner);
+	
 	/** Update relationship with nearby NPCs and players for social behaviors */
 	void UpdateSocialAwareness();
+	
+	/** Threat and social awareness plus perception tuning, run on a staggered schedule by the world subsystem */
+	void RunHeavyUpdate();
+	
+	friend class UCompanionWorldSubsystem;
 };
\ No newline at end of file
@@ -92,11 +92,7 @@ private:
     float SwimmingSpeed = 200.f;
     float FlyingSpeed   = 500.f;
 
-    /* ---------- Timers ------------------ */
-    FTimerHandle BlackboardUpdateTimer;
-
     /* ---------- Helpers ------------------ */
-    void UpdateBlackboard();
     void LoadMovementPreset();
     UFUNCTION() void OnRep_MovementPresetRow();
 
@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Perception/AIPerceptionTypes.h"
+#include "UObject/ObjectKey.h"
+
+/** One perception event kept in a companion's stimulus history */
+struct FCompanionStimulusRecord
+{
+    TObjectKey<AActor> Actor;
+    FAISenseID Sense;
+    FName Tag;
+    FVector Location = FVector::ZeroVector;
+    /** World time the stimulus arrived */
+    double Time = 0.0;
+    float Strength = 0.f;
+    /** Sensed (true) or lost (false) */
+    bool bSensed = false;
+};
+
+/**
+ * Fixed-capacity ring of a companion's most recent perception events.
+ * A small open-addressed index maps (actor, sense) to the newest event for that pair,
+ * so "when/where did I last see X" is a constant-time lookup that returns a pointer into the ring.
+ * Never allocates: both the ring and the index are inline arrays.
+ */
+class IKARUSTHECOMPANION_API FCompanionStimulusHistory
+{
+public:
+    static constexpr int32 Capacity = 32;
+
+    FCompanionStimulusHistory();
+
+    /** Append an event, evicting the oldest once full */
+    void Record(const AActor* Actor, const FAIStimulus& Stimulus, double Time);
+
+    /** Newest event for an actor and sense, or null if it dropped out of the ring (or never happened) */
+    const FCompanionStimulusRecord* FindLatest(const AActor* Actor, FAISenseID Sense) const;
+
+    /** Whether the newest event for an actor and sense is a successful sense no older than MaxAge */
+    bool IsSensed(const AActor* Actor, FAISenseID Sense, double Now, double MaxAge = TNumericLimits<double>::Max()) const;
+
+    /** Visit events newest first; stops when Visitor returns false */
+    template<typename TVisitor>
+    void ForEachNewestFirst(TVisitor&& Visitor) const
+    {
+        for (int32 Offset = 1; Offset <= Num; ++Offset)
+        {
+            if (!Visitor(Records[(Head - Offset + Capacity) % Capacity]))
+            {
+                return;
+            }
+        }
+    }
+
+    int32 GetNum() const { return Num; }
+
+    void Reset();
+
+private:
+    /** Index buckets; twice the ring capacity keeps the load factor at or below one half */
+    static constexpr int32 NumBuckets = Capacity * 2;
+    static constexpr int8 EmptyBucket = -1;
+
+    static uint32 HashOf(const TObjectKey<AActor>& Actor, FAISenseID Sense);
+
+    /** Bucket holding the index entry for (Actor, Sense), or INDEX_NONE */
+    int32 FindBucket(const TObjectKey<AActor>& Actor, FAISenseID Sense) const;
+
+    /** Remove an index entry, shifting later entries of the probe run back into place */
+    void RemoveBucket(int32 Bucket);
+
+    FCompanionStimulusRecord Records[Capacity];
+    /** Ring slot of the newest record of each (actor, sense) pair */
+    int8 Buckets[NumBuckets];
+
+    /** Next ring slot to write */
+    int32 Head = 0;
+    int32 Num = 0;
+};
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CompanionCore/CoreStructs/CompanionCoreStructs.h"
+
+/** One threat followed by a companion's threat tracker */
+struct FCompanionTrackedThreat
+{
+    TWeakObjectPtr<AActor> Actor;
+    FVector Location = FVector::ZeroVector;
+    float Distance = 0.f;
+    /** Damage dealt to us, decayed from LastDamageTime when scoring */
+    float Damage = 0.f;
+    double LastDamageTime = 0.0;
+    double LastSensedTime = 0.0;
+    bool bTargetsSelf = false;
+    bool bTargetsOwner = false;
+    float Score = 0.f;
+};
+
+/**
+ * Bounded set of threats a companion is tracking, kept as a max-heap on score.
+ * Scores blend proximity, recent damage and whether the threat is going after us or our owner,
+ * and are updated per threat as stimuli arrive. The selected target only moves to a new threat
+ * once it clearly outscores the current one, so a group of enemies does not make the companion
+ * flip targets on every stimulus.
+ */
+class IKARUSTHECOMPANION_API FCompanionThreatTracker
+{
+public:
+    static constexpr int32 Capacity = 8;
+
+    void SetScoring(const FCompanionThreatScoring& InScoring) { Scoring = InScoring; }
+
+    /**
+     * Insert or refresh a sensed threat.
+     * @return true if the selected target changed
+     */
+    bool ReportSighting(AActor* Actor, const FVector& Location, float Distance, bool bTargetsSelf, bool bTargetsOwner, double Now);
+
+    /**
+     * Add damage dealt by a threat, inserting it if unknown.
+     * @return true if the selected target changed
+     */
+    bool ReportDamage(AActor* Actor, float Amount, const FVector& Location, float Distance, double Now);
+
+    /**
+     * Re-score every threat for the passage of time and forget stale or destroyed ones.
+     * @return true if the selected target changed
+     */
+    bool Refresh(double Now);
+
+    /** Selected target (null when nothing is tracked) */
+    AActor* GetTarget() const { return Target.Get(); }
+
+    /** Tracked entry of the selected target */
+    const FCompanionTrackedThreat* GetTargetEntry() const;
+
+    /** Tracked threats in heap order (the first is the best scored) */
+    TConstArrayView<FCompanionTrackedThreat> GetThreats() const { return Heap; }
+
+    int32 Num() const { return Heap.Num(); }
+
+    void Reset();
+
+private:
+    float ScoreOf(const FCompanionTrackedThreat& Threat, double Now) const;
+
+    /** Re-score one entry after a change and restore the heap; inserts (evicting the weakest) when Index is INDEX_NONE */
+    void Commit(int32 Index, FCompanionTrackedThreat&& Threat, double Now);
+
+    /** Move the selected target to the best threat if it clearly outscores the current one */
+    bool SelectTarget();
+
+    int32 IndexOf(const AActor* Actor) const;
+
+    static bool HigherScore(const FCompanionTrackedThreat& A, const FCompanionTrackedThreat& B) { return A.Score > B.Score; }
+
+    FCompanionThreatScoring Scoring;
+    TArray<FCompanionTrackedThreat, TInlineAllocator<Capacity>> Heap;
+    TWeakObjectPtr<AActor> Target;
+};
@@ -0,0 +1,64 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AController;
+class UNavigationSystemV1;
+
+/**
+ * Ring of navmesh-projected follow positions around one player, shared by every companion following them.
+ * The ring is re-projected only after the player has moved past a threshold, and each companion claims
+ * one slot, so followers neither repeat each other's nav queries nor pile onto the same point.
+ */
+struct IKARUSTHECOMPANION_API FCompanionFollowSlotRing
+{
+    /** Lay out NumSlots evenly spaced slots Radius away from the player */
+    void Initialize(int32 NumSlots, float Radius);
+
+    /** Whether the player has moved far enough from the last projection anchor to re-project */
+    bool NeedsReprojection(const FVector& PlayerLocation, float Threshold) const;
+
+    /**
+     * Re-project every slot around the player's current location.
+     * @return number of navmesh projections issued
+     */
+    int32 Reproject(const UNavigationSystemV1& NavSys, const FVector& PlayerLocation);
+
+    /**
+     * Keep the claimant's slot, or claim the free valid slot nearest to From. Either way the claim is renewed at Now.
+     * @return false if every valid slot is taken by someone else
+     */
+    bool Claim(const AController* Claimant, const FVector& From, double Now, FVector& OutLocation);
+
+    /** Give up the claimant's slot, if any */
+    void Release(const AController* Claimant);
+
+    /** Free slots whose claimant has not renewed its claim within Timeout seconds */
+    void ExpireClaims(double Now, float Timeout);
+
+    /** Whether any live controller holds a slot */
+    bool HasClaims() const;
+
+    bool IsInitialized() const { return Slots.Num() > 0; }
+
+private:
+    struct FSlot
+    {
+        /** Offset from the player on the ground plane */
+        FVector Offset = FVector::ZeroVector;
+        /** Last projected position */
+        FVector Location = FVector::ZeroVector;
+        bool bValid = false;
+        TWeakObjectPtr<const AController> Claimant;
+        /** World time the claimant last claimed this slot */
+        double ClaimTime = 0.0;
+    };
+
+    TArray<FSlot, TInlineAllocator<8>> Slots;
+
+    /** Player location the slots were last projected around */
+    FVector Anchor = FVector::ZeroVector;
+    bool bProjected = false;
+};
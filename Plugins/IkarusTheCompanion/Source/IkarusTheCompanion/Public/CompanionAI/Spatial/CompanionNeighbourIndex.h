@@ -0,0 +1,120 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+#include "Tasks/Task.h"
+#include "CompanionCore/CoreEnums/CompanionEnums.h"
+#include "CompanionCore/CoreStructs/CompanionCoreStructs.h"
+
+class APawn;
+class UWorld;
+
+/**
+ * Broad-phase index of every pawn in the world (players, companions, NPCs) for social awareness.
+ * Pawn positions are snapshotted on the game thread, then sorted into a cell list on a worker thread.
+ * Two buffers are kept: queries read the last finished build while the next one is being sorted,
+ * so results are at most one rebuild old and the game thread never waits on the sort.
+ */
+struct IKARUSTHECOMPANION_API FCompanionNeighbourIndex
+{
+    /** One indexed pawn */
+    struct FNeighbour
+    {
+        TWeakObjectPtr<APawn> Pawn;
+        FVector Location = FVector::ZeroVector;
+        ECompanionNeighbourKind Kind = ECompanionNeighbourKind::NPC;
+    };
+
+    explicit FCompanionNeighbourIndex(float InCellSize = 1000.f);
+    ~FCompanionNeighbourIndex();
+
+    FCompanionNeighbourIndex(const FCompanionNeighbourIndex&) = delete;
+    FCompanionNeighbourIndex& operator=(const FCompanionNeighbourIndex&) = delete;
+
+    /** Change the cell size; takes effect from the next rebuild */
+    void SetCellSize(float InCellSize);
+
+    /**
+     * Publish the previous build if it finished, then snapshot every pawn and start sorting the next one.
+     * Skipped (keeping the current build) while the previous sort is still running.
+     */
+    void Rebuild(UWorld& World);
+
+    /** Wait for any in-flight build and drop both buffers */
+    void Reset();
+
+    /** Count the pawns within Radius of Origin by kind, ignoring Self */
+    void Summarise(const FVector& Origin, float Radius, const APawn* Self, FCompanionNeighbourSummary& OutSummary) const;
+
+    /** Call Visitor(const FNeighbour&, float DistSquared) for every indexed pawn within Radius of Origin */
+    template<typename TVisitor>
+    void ForEachWithin(const FVector& Origin, float Radius, TVisitor&& Visitor) const
+    {
+        const FBuffer& Front = Buffers[FrontIndex];
+        if (Front.Neighbours.Num() == 0 || Radius <= 0.f)
+        {
+            return;
+        }
+
+        const float RadiusSq = FMath::Square(Radius);
+        const FIntPoint MinCell = ToCell(Origin - FVector(Radius, Radius, 0.f), Front.InvCellSize);
+        const FIntPoint MaxCell = ToCell(Origin + FVector(Radius, Radius, 0.f), Front.InvCellSize);
+
+        for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+        {
+            // Cells of one column are contiguous in the sorted key list: one binary search per column
+            const uint64 LastKey = MakeKey(X, MaxCell.Y);
+            for (int32 Cell = Algo::LowerBound(Front.CellKeys, MakeKey(X, MinCell.Y)); Cell < Front.CellKeys.Num() && Front.CellKeys[Cell] <= LastKey; ++Cell)
+            {
+                for (int32 Idx = Front.CellStarts[Cell]; Idx < Front.CellStarts[Cell + 1]; ++Idx)
+                {
+                    const FNeighbour& Neighbour = Front.Neighbours[Idx];
+                    const float DistSq = FVector::DistSquared(Origin, Neighbour.Location);
+                    if (DistSq <= RadiusSq)
+                    {
+                        Visitor(Neighbour, DistSq);
+                    }
+                }
+            }
+        }
+    }
+
+    /** Number of pawns in the build queries currently read */
+    int32 Num() const { return Buffers[FrontIndex].Neighbours.Num(); }
+
+private:
+    /** One complete build: neighbours sorted by cell, plus the start of each occupied cell */
+    struct FBuffer
+    {
+        TArray<FNeighbour> Neighbours;
+        TArray<uint64> CellKeys;
+        /** CellKeys.Num() + 1 entries; the last one is Neighbours.Num() */
+        TArray<int32> CellStarts;
+        float InvCellSize = 1.f / 1000.f;
+    };
+
+    static FIntPoint ToCell(const FVector& Location, float InvCellSize)
+    {
+        return FIntPoint(FMath::FloorToInt32(Location.X * InvCellSize), FMath::FloorToInt32(Location.Y * InvCellSize));
+    }
+
+    /** Cell key whose unsigned order matches (X, Y) signed order */
+    static uint64 MakeKey(int32 X, int32 Y)
+    {
+        return (uint64(uint32(X) ^ 0x80000000u) << 32) | uint64(uint32(Y) ^ 0x80000000u);
+    }
+
+    /** Sort the back buffer into cells (runs on a worker thread) */
+    static void Build(FBuffer& Buffer);
+
+    FBuffer Buffers[2];
+    int32 FrontIndex = 0;
+    float CellSize;
+
+    UE::Tasks::FTask BuildTask;
+
+    /** The back buffer holds a build that has not been published yet */
+    bool bBackPending = false;
+};
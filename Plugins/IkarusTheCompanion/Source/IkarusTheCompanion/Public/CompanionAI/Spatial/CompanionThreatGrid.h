@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/SparseArray.h"
+#include "UObject/ObjectKey.h"
+#include "CompanionCore/CoreStructs/CompanionCoreStructs.h"
+
+/**
+ * Uniform 2D hash grid (XY) of hostile actors shared by every companion in a world.
+ * Actors are re-bucketed only when they cross a cell boundary, and radius queries
+ * visit just the cells they overlap, so query cost follows local occupancy rather
+ * than the total number of threats.
+ */
+struct IKARUSTHECOMPANION_API FCompanionThreatGrid
+{
+    explicit FCompanionThreatGrid(float InCellSize = 1000.f);
+
+    /** Start tracking an actor, or mark a tracked one as reported again at Now */
+    void Add(AActor* Actor, double Now);
+
+    /** Stop tracking an actor */
+    void Remove(const AActor* Actor);
+
+    bool Contains(const AActor* Actor) const { return ActorToEntry.Contains(Actor); }
+
+    /**
+     * Refresh every tracked location, moving actors between cells as needed.
+     * Drops destroyed actors and ones nobody has reported for longer than ForgetAfterSeconds.
+     */
+    void Refresh(double Now, float ForgetAfterSeconds);
+
+    /**
+     * Up to MaxResults threats within Radius of Origin, nearest first.
+     * @return number of results written to OutThreats (which is reset first)
+     */
+    int32 QueryNearest(const FVector& Origin, float Radius, int32 MaxResults, TArray<FCompanionThreatInfo>& OutThreats) const;
+
+    /** Whether any threat lies within Radius of Origin (stops at the first hit) */
+    bool AnyWithin(const FVector& Origin, float Radius) const;
+
+    int32 Num() const { return Entries.Num(); }
+
+    void Reset();
+
+private:
+    struct FEntry
+    {
+        TWeakObjectPtr<AActor> Actor;
+        /** Kept alongside the weak pointer so the reverse map can be cleaned up after the actor is gone */
+        TObjectKey<AActor> Key;
+        FVector Location = FVector::ZeroVector;
+        FIntPoint Cell = FIntPoint::ZeroValue;
+        /** World time of the last Add for this actor */
+        double LastReportTime = 0.0;
+    };
+
+    using FCell = TArray<int32, TInlineAllocator<4>>;
+
+    FIntPoint ToCell(const FVector& Location) const;
+
+    void AddToCell(const FIntPoint& Cell, int32 EntryIndex);
+    void RemoveFromCell(const FIntPoint& Cell, int32 EntryIndex);
+    void RemoveEntry(int32 EntryIndex);
+
+    /** Call Visitor(EntryIndex, DistSquared) for every entry within Radius; stops when Visitor returns false */
+    template<typename TVisitor>
+    void ForEachWithin(const FVector& Origin, float Radius, TVisitor&& Visitor) const;
+
+    float CellSize;
+    float InvCellSize;
+
+    TSparseArray<FEntry> Entries;
+    TMap<FIntPoint, FCell> Cells;
+    TMap<TObjectKey<AActor>, int32> ActorToEntry;
+};
@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * World-wide negative cache of destinations that failed pathfinding, bucketed into 3D cells.
+ * A cell stays unreachable for a TTL that doubles with every repeated failure up to a cap, so
+ * cliffs, water and closed buildings stop drawing path queries while a one-off failure is soon
+ * forgotten. Escalation resets once a cell has been quiet for the maximum TTL.
+ */
+class IKARUSTHECOMPANION_API FCompanionUnreachableCache
+{
+public:
+    explicit FCompanionUnreachableCache(float InCellSize = 200.f, float InBaseTTL = 5.f, float InMaxTTL = 60.f);
+
+    /** Record a failed path towards Location */
+    void MarkUnreachable(const FVector& Location, double Now);
+
+    /** Forget Location's cell, e.g. after something reached it */
+    void ClearUnreachable(const FVector& Location);
+
+    /** Whether Location's cell is still inside its TTL */
+    bool IsUnreachable(const FVector& Location, double Now) const;
+
+    /** Drop cells whose TTL ran out longer than the maximum TTL ago */
+    void Prune(double Now);
+
+    int32 Num() const { return Cells.Num(); }
+
+    void Reset() { Cells.Reset(); }
+
+private:
+    struct FEntry
+    {
+        double ExpiresAt = 0.0;
+        int32 Failures = 0;
+    };
+
+    FIntVector ToCell(const FVector& Location) const;
+
+    TMap<FIntVector, FEntry> Cells;
+
+    float CellSize;
+    float BaseTTL;
+    float MaxTTL;
+};
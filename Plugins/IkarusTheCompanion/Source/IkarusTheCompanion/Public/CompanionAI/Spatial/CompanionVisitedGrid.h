@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Bit-packed record of the places an owner's companions have recently used or searched.
+ * The XY plane is folded onto a fixed Dim x Dim torus of cells, one bit per cell, and time decay
+ * comes from a ring of bit planes: marks go into the plane of the current time slice, and a plane
+ * is wiped when its slice comes round again. Marking and lookups are O(1) and memory stays fixed
+ * however long the memory window is. Cells a whole torus apart alias, which is harmless at the
+ * distances companions search over.
+ */
+class IKARUSTHECOMPANION_API FCompanionVisitedGrid
+{
+public:
+    /** Cells per side; one row of the torus is one 64-bit word */
+    static constexpr int32 Dim = 64;
+
+    /** Time slices kept; a mark is forgotten between (NumPlanes - 1) and NumPlanes slices after it was made */
+    static constexpr int32 NumPlanes = 4;
+
+    explicit FCompanionVisitedGrid(float InCellSize = 200.f, float InMemorySeconds = 60.f);
+
+    /** Record Location as visited at time Now */
+    void Mark(const FVector& Location, double Now);
+
+    /** Whether Location's cell was marked within the memory window */
+    bool IsVisited(const FVector& Location, double Now) const;
+
+    /** Visited cells in the 3x3 block around Location's cell (0-9) */
+    int32 CountVisitedAround(const FVector& Location, double Now) const;
+
+    void Reset();
+
+private:
+    FIntPoint ToCell(const FVector& Location) const;
+
+    int64 SliceOf(double Now) const;
+
+    /** Cell bit in any plane still inside the memory window; X and Y wrap around the torus */
+    bool TestCell(int32 X, int32 Y, int64 Slice) const;
+
+    uint64 Planes[NumPlanes][Dim];
+
+    /** Time slice each plane currently holds */
+    int64 PlaneSlices[NumPlanes];
+
+    float CellSize;
+    double SliceSeconds;
+};
@@ -0,0 +1,363 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CompanionCore/CoreEnums/CompanionEnums.h"
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardSnapshot.h"
+#include "CompanionAI/Spatial/CompanionThreatGrid.h"
+#include "CompanionAI/Spatial/CompanionNeighbourIndex.h"
+#include "CompanionAI/Spatial/CompanionFollowSlots.h"
+#include "CompanionAI/Spatial/CompanionVisitedGrid.h"
+#include "CompanionAI/Spatial/CompanionUnreachableCache.h"
+#include "CompanionWorldSubsystem.generated.h"
+
+class AAICompanionController;
+class ACharacter;
+class APawn;
+
+/**
+ * Cold state of a companion collapsed out of the world while no player is near.
+ * Preserves the pawn and controller classes, transform, owner, "Stay" command, raw-copyable blackboard keys
+ * and the SaveGame properties of the pawn, its components and the controller (see ICompanionVirtualState).
+ * String/struct keys, perception memory, BT node memory and the running branch start over.
+ */
+USTRUCT()
+struct IKARUSTHECOMPANION_API FVirtualCompanionRecord
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TSubclassOf<APawn> PawnClass;
+
+    UPROPERTY()
+    TSubclassOf<AAICompanionController> ControllerClass;
+
+    UPROPERTY()
+    FTransform Transform;
+
+    UPROPERTY()
+    TWeakObjectPtr<ACharacter> OwnerPlayer;
+
+    /** The companion had been told to stay and settles back into hibernation once respawned */
+    UPROPERTY()
+    bool bStayCommanded = false;
+
+    /** SaveGame properties of the pawn and its components (stats, mood, loyalty...) */
+    UPROPERTY()
+    TArray<uint8> PawnState;
+
+    /** SaveGame properties of the controller */
+    UPROPERTY()
+    TArray<uint8> ControllerState;
+
+    /** Plain-data blackboard values at the time of virtualisation, current task type included */
+    FCompanionBlackboardSnapshot Blackboard;
+};
+
+/**
+ * World-level driver for companions: batches per-frame blackboard updates, budgets heavy work and queries,
+ * and owns the shared spatial data (threats, neighbours, follow slots, AI LOD and virtualisation).
+ */
+UCLASS(Config=Game)
+class IKARUSTHECOMPANION_API UCompanionWorldSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /* ---------- Subsystem overrides ---------- */
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /** Add a companion to the batched update (called when its controller possesses a pawn) */
+    void RegisterCompanion(AAICompanionController* Controller);
+
+    /** Remove a companion from the batched update */
+    void UnregisterCompanion(AAICompanionController* Controller);
+
+    /** Change how often a registered companion gets its blackboard refreshed */
+    void SetCompanionUpdateInterval(const AAICompanionController* Controller, float Interval);
+
+    /** Number of companions currently driven by this subsystem */
+    UFUNCTION(BlueprintCallable, Category="AI|Performance")
+    int32 GetNumCompanions() const { return Controllers.Num(); }
+
+    /** Collapse a companion into a virtual record, destroying its pawn and controller */
+    bool VirtualiseCompanion(AAICompanionController* Controller);
+
+    /** Number of companions currently held as virtual records */
+    UFUNCTION(BlueprintCallable, Category="AI|Performance")
+    int32 GetNumVirtualCompanions() const { return VirtualRecords.Num(); }
+
+    /**
+     * Frames bucketed by how many companions ran heavy work on them:
+     * entry N counts frames where N companions ran (the last entry also collects anything above budget).
+     */
+    const TArray<int32>& GetHeavyWorkHistogram() const { return HeavyWorkHistogram; }
+
+    /** Clear the heavy-work histogram */
+    UFUNCTION(BlueprintCallable, Category="AI|Performance")
+    void ResetHeavyWorkHistogram();
+
+    /** Log the heavy-work histogram */
+    UFUNCTION(BlueprintCallable, Category="AI|Performance")
+    void LogHeavyWorkHistogram() const;
+
+    /**
+     * Queue a piece of work to run within the per-frame budget.
+     * Work whose owner is destroyed before it runs is dropped.
+     * @return handle for CancelWork (never 0)
+     */
+    uint32 SubmitWork(const UObject* Owner, TFunction<void()>&& Work);
+
+    /** Drop a queued work item; no-op if it already ran */
+    void CancelWork(uint32 Handle);
+
+    /** Number of work items waiting for budget */
+    UFUNCTION(BlueprintCallable, Category="AI|Performance")
+    int32 GetNumPendingWork() const { return WorkQueue.Num(); }
+
+    /** Milliseconds spent running queued work last frame */
+    UFUNCTION(BlueprintCallable, Category="AI|Performance")
+    float GetLastFrameWorkMs() const { return LastFrameWorkMs; }
+
+    /**
+     * Track a hostile actor in the shared threat grid, or keep tracking it. Threats drop out once destroyed
+     * or after ThreatForgetSeconds without any companion reporting them.
+     */
+    UFUNCTION(BlueprintCallable, Category="AI|Threat")
+    void RegisterThreat(AActor* Threat);
+
+    /** Number of hostile actors currently tracked */
+    UFUNCTION(BlueprintCallable, Category="AI|Threat")
+    int32 GetNumThreats() const { return ThreatGrid.Num(); }
+
+    /** Shared threat grid, refreshed once per frame before heavy work runs */
+    const FCompanionThreatGrid& GetThreatGrid() const { return ThreatGrid; }
+
+    /** Pawn index for "who is near me" queries; reflects positions from the last finished rebuild */
+    const FCompanionNeighbourIndex& GetNeighbourIndex() const { return NeighbourIndex; }
+
+    /**
+     * Claim a navmesh follow position around a player, shared with the player's other followers.
+     * The claimant keeps its slot across calls until released, the slot drops off the navmesh,
+     * or it goes FollowSlotClaimTimeout seconds without claiming again.
+     * @return false if every slot around the player is taken or off the navmesh
+     */
+    bool ClaimFollowSlot(const AActor* Player, const AController* Claimant, FVector& OutLocation);
+
+    /** Give up any follow slot held by the claimant */
+    void ReleaseFollowSlot(const AController* Claimant);
+
+    /** Navmesh projections issued for follow slots since the world started */
+    UFUNCTION(BlueprintCallable, Category="AI|Performance")
+    int32 GetNumFollowSlotProjections() const { return FollowSlotProjections; }
+
+    /** Recently used and searched places shared by the companions of Owner, created on first use */
+    FCompanionVisitedGrid& GetVisitedGrid(const AActor* Owner);
+
+    /** Record a destination that failed pathfinding; shared by every companion in the world */
+    void MarkUnreachable(const FVector& Location);
+
+    /** Forget a destination previously marked unreachable */
+    void ClearUnreachable(const FVector& Location);
+
+    /** Whether pathfinding towards Location failed recently enough to skip it */
+    bool IsUnreachable(const FVector& Location) const;
+
+    /** Distance at which owner proximity reaches zero */
+    static constexpr float MaxProximityRange = 2000.f;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    /* ---------- Time-sliced work queue ---------- */
+
+    /** Milliseconds per frame queued companion work may use; at least one item always runs */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Scheduling", meta=(ClampMin="0.0"))
+    float WorkBudgetMs = 1.0f;
+
+    /* ---------- Heavy work scheduling ---------- */
+
+    /** Seconds between heavy updates (threat/social awareness) for one companion; never faster than its blackboard interval */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Scheduling", meta=(ClampMin="0.05"))
+    float HeavyUpdateInterval = 0.4f;
+
+    /** Most companions allowed to run heavy work in a single frame; the rest wait their turn */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Scheduling", meta=(ClampMin="1"))
+    int32 MaxHeavyUpdatesPerFrame = 4;
+
+    /* ---------- Threat awareness ---------- */
+
+    /** Edge length of a threat grid cell; roughly the typical awareness radius works well */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Threat", meta=(ClampMin="100.0"))
+    float ThreatCellSize = 1000.f;
+
+    /** Seconds a threat stays in the grid after the last companion reported perceiving it */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Threat", meta=(ClampMin="0.0"))
+    float ThreatForgetSeconds = 10.f;
+
+    /* ---------- Social awareness ---------- */
+
+    /** Edge length of a neighbour index cell */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Social", meta=(ClampMin="100.0"))
+    float NeighbourCellSize = 1000.f;
+
+    /* ---------- Follow slots ---------- */
+
+    /** Follow positions kept around each followed player */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Follow", meta=(ClampMin="1", ClampMax="32"))
+    int32 FollowSlotsPerPlayer = 8;
+
+    /** Distance of the follow positions from the player */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Follow", meta=(ClampMin="0.0"))
+    float FollowSlotRadius = 250.f;
+
+    /** How far the player must move before the follow positions are re-projected */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Follow", meta=(ClampMin="0.0"))
+    float FollowSlotReprojectDistance = 150.f;
+
+    /** Seconds a follow slot stays claimed without its claimant claiming it again */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Follow", meta=(ClampMin="0.0"))
+    float FollowSlotClaimTimeout = 5.f;
+
+    /* ---------- Visited locations ---------- */
+
+    /** Edge length of a visited-grid cell; points in the same cell count as the same place */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Search", meta=(ClampMin="10.0"))
+    float VisitedCellSize = 200.f;
+
+    /** How long a visited place is remembered */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Search", meta=(ClampMin="1.0"))
+    float VisitedMemorySeconds = 60.f;
+
+    /* ---------- Unreachable destinations ---------- */
+
+    /** Edge length of an unreachable-destination cell */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Navigation", meta=(ClampMin="10.0"))
+    float UnreachableCellSize = 200.f;
+
+    /** Seconds a destination is skipped after its first failed path; doubles with every repeat failure */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Navigation", meta=(ClampMin="0.0"))
+    float UnreachableTTL = 5.f;
+
+    /** Longest a destination is skipped after repeated failures */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Navigation", meta=(ClampMin="0.0"))
+    float UnreachableMaxTTL = 60.f;
+
+    /* ---------- Significance / AI LOD ---------- */
+
+    /** Seconds between AI LOD re-evaluations */
+    UPROPERTY(Config, EditAnywhere, Category="AI|LOD", meta=(ClampMin="0.05"))
+    float LODEvaluationInterval = 0.5f;
+
+    /** Distance multiplier for companions inside a player's view cone (lower = more significant) */
+    UPROPERTY(Config, EditAnywhere, Category="AI|LOD", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float OnScreenDistanceScale = 0.5f;
+
+    /** Half-angle of the view cone treated as "on screen" */
+    UPROPERTY(Config, EditAnywhere, Category="AI|LOD", meta=(ClampMin="0.0", ClampMax="180.0"))
+    float OnScreenHalfAngleDegrees = 50.f;
+
+    /* ---------- Virtualisation ---------- */
+
+    /** Seconds a companion must stay in the Dormant LOD bucket before it is virtualised */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Virtualisation", meta=(ClampMin="0.0"))
+    float VirtualiseAfterSeconds = 10.f;
+
+    /** Virtual companions within this distance of a player view are respawned as full actors */
+    UPROPERTY(Config, EditAnywhere, Category="AI|Virtualisation", meta=(ClampMin="0.0"))
+    float RehydrateDistance = 8000.f;
+
+private:
+    /** One queued piece of budgeted work */
+    struct FWorkItem
+    {
+        uint32 Handle = 0;
+        TWeakObjectPtr<const UObject> Owner;
+        TFunction<void()> Work;
+    };
+
+    /* ---------- Companion state (all arrays index-aligned) ---------- */
+    TArray<TWeakObjectPtr<AAICompanionController>> Controllers;
+    TArray<FVector> CompanionLocations;
+    TArray<FVector> OwnerLocations;
+    TArray<float>   OwnerDistances;
+    TArray<float>   OwnerProximities;
+    TArray<float>   UpdateIntervals;
+    TArray<float>   TimeUntilUpdate;
+    TArray<bool>    HasOwner;
+    TArray<float>   DormantTimes;
+    TArray<float>   TimeUntilHeavyUpdate;
+
+    /* ---------- Virtual companions (index-aligned) ---------- */
+    TArray<FVector> VirtualLocations;
+
+    UPROPERTY(Transient)
+    TArray<FVirtualCompanionRecord> VirtualRecords;
+
+    /* ---------- Per-frame scratch ---------- */
+    TArray<int32> DueIndices;
+    TArray<TWeakObjectPtr<AAICompanionController>> StaleControllers;
+    TArray<FVector> ViewLocations;
+    TArray<FVector> ViewDirections;
+    TArray<TWeakObjectPtr<AAICompanionController>> PendingVirtualise;
+
+    /* ---------- Work queue ---------- */
+    TArray<FWorkItem> WorkQueue;
+    TArray<FWorkItem> RunningWork;
+    TArray<FWorkItem> DeferredWork;
+    TSet<const UObject*> OwnersServedThisFrame;
+    uint32 NextWorkHandle = 1;
+    float LastFrameWorkMs = 0.f;
+
+    /* ---------- Threats ---------- */
+    FCompanionThreatGrid ThreatGrid;
+
+    /* ---------- Neighbours ---------- */
+    FCompanionNeighbourIndex NeighbourIndex;
+
+    /* ---------- Follow slots ---------- */
+    struct FFollowSlotEntry
+    {
+        TWeakObjectPtr<const AActor> Player;
+        FCompanionFollowSlotRing Ring;
+    };
+    TMap<TObjectKey<AActor>, FFollowSlotEntry> FollowSlots;
+    int32 FollowSlotProjections = 0;
+
+    /** Expire stale claims, re-project rings whose player moved and drop rings nobody follows any more */
+    void UpdateFollowSlots();
+
+    /* ---------- Visited locations ---------- */
+    TMap<TObjectKey<AActor>, FCompanionVisitedGrid> VisitedGrids;
+
+    /* ---------- Unreachable destinations ---------- */
+    FCompanionUnreachableCache UnreachableCache;
+
+    /** Slot the next heavy-work pass starts scanning from, so overdue companions are served round-robin */
+    int32 HeavyWorkCursor = 0;
+
+    /** Frames counted by number of heavy updates run */
+    TArray<int32> HeavyWorkHistogram;
+
+    /** Time until the next AI LOD pass */
+    float TimeUntilLODEvaluation = 0.f;
+
+    void RemoveAtSlot(int32 Slot);
+
+    /** Run queued work until the frame budget is spent, at most one item per owner per frame */
+    void RunWorkQueue();
+
+    /** Run heavy work for due companions, up to MaxHeavyUpdatesPerFrame */
+    void RunHeavyUpdates(float DeltaTime);
+
+    /** Re-bucket every companion by its distance to the most relevant player view */
+    void EvaluateAILOD();
+
+    /** Respawn a virtual companion as a full pawn + controller */
+    void RehydrateCompanion(int32 VirtualIndex);
+};
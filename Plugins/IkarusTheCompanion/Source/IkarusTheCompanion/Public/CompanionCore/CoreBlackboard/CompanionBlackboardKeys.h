@@ -0,0 +1,250 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AISystem.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "UObject/ObjectKey.h"
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardWriteBuffer.h"
+
+class UBlackboardData;
+class UWorld;
+
+/** Applied vs. suppressed counts for change-detecting writes to one key */
+struct FCompanionBlackboardWriteStats
+{
+    uint32 Applied = 0;
+    uint32 Suppressed = 0;
+};
+
+namespace CompanionBlackboard
+{
+    /** Whether a new value is close enough to the current one to skip the write */
+    template<typename T>
+    FORCEINLINE bool IsWithinTolerance(const T& Current, const T& New, float Tolerance) { return Current == New; }
+
+    FORCEINLINE bool IsWithinTolerance(float Current, float New, float Tolerance)
+    {
+        return FMath::Abs(Current - New) <= Tolerance;
+    }
+
+    FORCEINLINE bool IsWithinTolerance(const FVector& Current, const FVector& New, float Tolerance)
+    {
+        // An unset vector key always takes the first write
+        return FAISystem::IsValidLocation(Current) && FVector::DistSquared(Current, New) <= FMath::Square(Tolerance);
+    }
+}
+
+/**
+ * Blackboard key whose ID is resolved once per blackboard asset.
+ * Reads and writes go straight to the key ID; keys missing from the asset are silently skipped.
+ */
+template<typename TKeyType>
+struct TCompanionBlackboardKey
+{
+    using FDataType = typename TKeyType::FDataType;
+
+    /** Resolved key ID (InvalidKey when the asset has no matching key of this type) */
+    FBlackboard::FKey ID = FBlackboard::InvalidKey;
+
+    /** Changes up to this size are dropped by Update (absolute difference for floats, distance for vectors) */
+    float Tolerance = 0.f;
+
+    /** Counters for Update, shared by every companion using the same blackboard asset */
+    mutable FCompanionBlackboardWriteStats Stats;
+
+    FORCEINLINE bool IsValid() const { return ID != FBlackboard::InvalidKey; }
+
+    /**
+     * Change-detecting write: skipped when the value is within Tolerance of what the blackboard
+     * already holds, so observers and decorators are not woken for noise.
+     * @return true if the value was written
+     */
+    FORCEINLINE bool Update(UBlackboardComponent& Blackboard, FDataType Value) const
+    {
+        if (!IsValid())
+        {
+            return false;
+        }
+
+        if (CompanionBlackboard::IsWithinTolerance(Blackboard.GetValue<TKeyType>(ID), Value, Tolerance))
+        {
+            ++Stats.Suppressed;
+            return false;
+        }
+
+        ++Stats.Applied;
+        Blackboard.SetValue<TKeyType>(ID, Value);
+        return true;
+    }
+
+    FORCEINLINE bool Update(UBlackboardComponent* Blackboard, FDataType Value) const
+    {
+        return Blackboard ? Update(*Blackboard, Value) : false;
+    }
+
+    /** Queue a write into a frame buffer instead of writing the blackboard directly */
+    FORCEINLINE void Set(FCompanionBlackboardWriteBuffer& Buffer, FDataType Value) const
+    {
+        if (IsValid())
+        {
+            Buffer.Write<TKeyType>(ID, Value);
+        }
+    }
+
+    /** Change-detecting write against the blackboard's current value, queued into a frame buffer */
+    FORCEINLINE bool Update(const UBlackboardComponent& Blackboard, FCompanionBlackboardWriteBuffer& Buffer, FDataType Value) const
+    {
+        if (!IsValid())
+        {
+            return false;
+        }
+
+        if (CompanionBlackboard::IsWithinTolerance(Blackboard.GetValue<TKeyType>(ID), Value, Tolerance))
+        {
+            ++Stats.Suppressed;
+            return false;
+        }
+
+        ++Stats.Applied;
+        Buffer.Write<TKeyType>(ID, Value);
+        return true;
+    }
+
+    FORCEINLINE void Set(UBlackboardComponent& Blackboard, FDataType Value) const
+    {
+        if (IsValid())
+        {
+            Blackboard.SetValue<TKeyType>(ID, Value);
+        }
+    }
+
+    FORCEINLINE void Set(UBlackboardComponent* Blackboard, FDataType Value) const
+    {
+        if (Blackboard)
+        {
+            Set(*Blackboard, Value);
+        }
+    }
+
+    FORCEINLINE FDataType Get(const UBlackboardComponent& Blackboard) const
+    {
+        return IsValid() ? Blackboard.GetValue<TKeyType>(ID) : TKeyType::InvalidValue;
+    }
+
+    FORCEINLINE FDataType Get(const UBlackboardComponent* Blackboard) const
+    {
+        return Blackboard ? Get(*Blackboard) : TKeyType::InvalidValue;
+    }
+};
+
+using FCompanionBoolKey   = TCompanionBlackboardKey<UBlackboardKeyType_Bool>;
+using FCompanionIntKey    = TCompanionBlackboardKey<UBlackboardKeyType_Int>;
+using FCompanionFloatKey  = TCompanionBlackboardKey<UBlackboardKeyType_Float>;
+using FCompanionEnumKey   = TCompanionBlackboardKey<UBlackboardKeyType_Enum>;
+using FCompanionVectorKey = TCompanionBlackboardKey<UBlackboardKeyType_Vector>;
+using FCompanionObjectKey = TCompanionBlackboardKey<UBlackboardKeyType_Object>;
+
+/**
+ * Typed registry of every blackboard key the companion code reads or writes.
+ * Resolved once per UBlackboardData asset and shared by every companion using it,
+ * so hot paths never construct FNames or search keys by name.
+ *
+ * Usage: Keys.OwnerDistance.Set(BB, Distance);    // always writes
+ *        Keys.OwnerDistance.Update(BB, Distance); // skips changes within the key's tolerance
+ */
+struct IKARUSTHECOMPANION_API FCompanionBlackboardKeys
+{
+    /* ---------- References ---------- */
+    FCompanionObjectKey SelfActor;
+    FCompanionObjectKey CompanionRef;
+    FCompanionObjectKey PlayerRef;
+    FCompanionObjectKey ThreatActor;
+    FCompanionObjectKey ResourceActor;
+
+    /* ---------- Locations ---------- */
+    FCompanionVectorKey HomeLocation;
+    FCompanionVectorKey OwnerLocation;
+    FCompanionVectorKey CompanionLocation;
+    FCompanionVectorKey LastKnownPlayerLocation;
+    FCompanionVectorKey ThreatLocation;
+    FCompanionVectorKey ResourceLocation;
+
+    /* ---------- Distances ---------- */
+    FCompanionFloatKey OwnerDistance;
+    FCompanionFloatKey OwnerProximity;
+    FCompanionFloatKey CompanionDistance;
+    FCompanionFloatKey CompanionProximity;
+
+    /* ---------- Utility scores ---------- */
+    FCompanionFloatKey IdleScore;
+    FCompanionFloatKey FollowScore;
+    FCompanionFloatKey PatrolScore;
+    FCompanionFloatKey GatherScore;
+    FCompanionFloatKey CombatScore;
+    FCompanionFloatKey ExplorationPercentage;
+
+    /* ---------- Task state ---------- */
+    FCompanionEnumKey CurrentTaskType;
+    FCompanionBoolKey IsTaskActive;
+    FCompanionBoolKey IsFollowing;
+    FCompanionBoolKey IsPatrolling;
+    FCompanionBoolKey IsGathering;
+    FCompanionBoolKey HasValidTarget;
+
+    /* ---------- Awareness ---------- */
+    FCompanionBoolKey IsOwnerSeen;
+    FCompanionBoolKey IsPlayerSeen;
+    FCompanionBoolKey IsOwnerInDanger;
+    FCompanionBoolKey IsSelfInDanger;
+    FCompanionBoolKey IsThreatDetected;
+    FCompanionBoolKey IsResourceDetected;
+
+    /* ---------- Social (optional) ---------- */
+    FCompanionIntKey    NearbyPlayerCount;
+    FCompanionIntKey    NearbyCompanionCount;
+    FCompanionIntKey    NearbyNPCCount;
+    FCompanionObjectKey NearestNeighbour;
+
+    /* ---------- Survival ---------- */
+    FCompanionIntKey   InventorySpace;
+    FCompanionIntKey   ResourceAmount;
+    FCompanionFloatKey CurrentStamina;
+    FCompanionFloatKey MaxStamina;
+
+    /**
+     * Registry for a blackboard asset, resolved on first use. Returns an all-invalid registry for null.
+     * Re-resolved in place when the asset's keys change, so references stay valid.
+     */
+    static const FCompanionBlackboardKeys& Get(const UBlackboardData* Asset);
+
+    /** Registry for the asset a blackboard component was initialized with */
+    static const FCompanionBlackboardKeys& Get(const UBlackboardComponent& Blackboard);
+
+    /** Log applied/suppressed counts of every key that has seen change-detecting writes */
+    void LogWriteStats() const;
+
+private:
+    /** Look up every key ID by name in the asset and assign write tolerances */
+    void Resolve(const UBlackboardData& Asset);
+
+    /** Every resolved registry by asset; hooks the invalidation delegates on first use */
+    static TMap<FObjectKey, TUniquePtr<FCompanionBlackboardKeys>>& GetRegistries();
+
+    /** Key IDs of an asset changed (edited, reparented or reloaded) */
+    static void HandleKeysUpdated(UBlackboardData* Asset);
+
+    /** A world was torn down (PIE end, level change): drop registries of assets that are gone */
+    static void HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+    /** Write counters of every key, by name, for LogWriteStats */
+    TArray<TPair<FName, const FCompanionBlackboardWriteStats*>> WriteStats;
+};
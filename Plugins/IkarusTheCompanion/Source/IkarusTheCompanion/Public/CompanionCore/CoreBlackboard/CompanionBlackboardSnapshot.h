@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "BehaviorTree/BlackboardData.h"
+
+class UBlackboardComponent;
+class UBlackboardData;
+class UBlackboardKeyType;
+
+/**
+ * Raw copy of a blackboard's plain-data keys (bool, int, float, enum, name, vector, rotator, object and class refs).
+ * Captured from one blackboard (or baked per asset with SetValue) and restored into another
+ * instance of the same asset in one pass, without per-key observer notifications.
+ */
+struct IKARUSTHECOMPANION_API FCompanionBlackboardSnapshot
+{
+    /** Location of one key's value inside Values */
+    struct FEntry
+    {
+        FBlackboard::FKey KeyID = FBlackboard::InvalidKey;
+        uint16 Offset = 0;
+        uint16 Size = 0;
+    };
+
+    /** Copy every plain-data key out of a blackboard */
+    void Capture(const UBlackboardComponent& Blackboard);
+
+    /**
+     * Bake a single value for a key of the given asset without a live blackboard.
+     * Used to build default-value templates; ignored for keys that are not raw-copyable.
+     */
+    template<typename TKeyType>
+    void SetValue(const UBlackboardData& InAsset, FBlackboard::FKey KeyID, typename TKeyType::FDataType Value)
+    {
+        const FBlackboardEntry* Key = InAsset.GetKey(KeyID);
+        TKeyType* KeyType = Key ? Cast<TKeyType>(Key->KeyType) : nullptr;
+        if (!KeyType || !IsRawCopyable(KeyType) || (Asset.IsValid() && Asset.Get() != &InAsset))
+        {
+            return;
+        }
+        Asset = &InAsset;
+
+        FEntry* Entry = Entries.FindByPredicate([KeyID](const FEntry& Existing) { return Existing.KeyID == KeyID; });
+        if (!Entry)
+        {
+            Entry = &Entries.AddDefaulted_GetRef();
+            Entry->KeyID = KeyID;
+            Entry->Offset = static_cast<uint16>(Values.Num());
+            Entry->Size = static_cast<uint16>(KeyType->GetValueSize());
+            Values.AddZeroed(Entry->Size);
+        }
+        TKeyType::SetValue(KeyType, Values.GetData() + Entry->Offset, Value);
+    }
+
+    /** Write the captured values back. Fails when the blackboard uses a different asset. */
+    bool Restore(UBlackboardComponent& Blackboard) const;
+
+    /** Drop all captured values */
+    void Reset();
+
+    bool IsEmpty() const { return Entries.Num() == 0; }
+
+    /** Asset the values were captured from */
+    const UBlackboardData* GetAsset() const { return Asset.Get(); }
+
+    /** Whether a key type's value memory can be copied byte-for-byte */
+    static bool IsRawCopyable(const UBlackboardKeyType* KeyType);
+
+protected:
+    TWeakObjectPtr<const UBlackboardData> Asset;
+    TArray<FEntry> Entries;
+    TArray<uint8> Values;
+};
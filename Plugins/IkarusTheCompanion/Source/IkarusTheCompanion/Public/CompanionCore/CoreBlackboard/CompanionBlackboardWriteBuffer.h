@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "BehaviorTree/BlackboardComponent.h"
+
+/**
+ * Collects blackboard writes made during a frame and applies them in one flush.
+ * Writes to the same key are coalesced (last write wins), and observers are notified
+ * once per changed key after every value is in place instead of once per write.
+ */
+struct IKARUSTHECOMPANION_API FCompanionBlackboardWriteBuffer
+{
+    /** Queue a typed write, replacing any earlier write to the same key this frame */
+    template<typename TKeyType>
+    void Write(FBlackboard::FKey KeyID, typename TKeyType::FDataType Value)
+    {
+        using FDataType = typename TKeyType::FDataType;
+        static_assert(TIsTriviallyCopyConstructible<FDataType>::Value, "Buffered blackboard values must be trivially copyable");
+
+        FPendingWrite* Pending = Writes.FindByPredicate([KeyID](const FPendingWrite& Write) { return Write.KeyID == KeyID; });
+        if (!Pending)
+        {
+            Pending = &Writes.AddDefaulted_GetRef();
+            Pending->KeyID = KeyID;
+            Pending->Offset = Values.AddUninitialized(sizeof(FDataType));
+            Pending->Apply = &ApplyTyped<TKeyType>;
+        }
+        FMemory::Memcpy(Values.GetData() + Pending->Offset, &Value, sizeof(FDataType));
+    }
+
+    /** Apply every queued write with a single observer notification pass, then clear the buffer */
+    void Flush(UBlackboardComponent& Blackboard);
+
+    /** Drop queued writes without applying them */
+    void Reset();
+
+    bool HasPendingWrites() const { return Writes.Num() > 0; }
+    int32 GetNumPendingWrites() const { return Writes.Num(); }
+
+private:
+    using FApplyFunc = void (*)(UBlackboardComponent&, FBlackboard::FKey, const uint8*);
+
+    struct FPendingWrite
+    {
+        FBlackboard::FKey KeyID = FBlackboard::InvalidKey;
+        int32 Offset = 0;
+        FApplyFunc Apply = nullptr;
+    };
+
+    template<typename TKeyType>
+    static void ApplyTyped(UBlackboardComponent& Blackboard, FBlackboard::FKey KeyID, const uint8* RawValue)
+    {
+        typename TKeyType::FDataType Value;
+        FMemory::Memcpy(&Value, RawValue, sizeof(Value));
+        Blackboard.SetValue<TKeyType>(KeyID, Value);
+    }
+
+    TArray<FPendingWrite, TInlineAllocator<16>> Writes;
+    TArray<uint8, TInlineAllocator<256>> Values;
+};
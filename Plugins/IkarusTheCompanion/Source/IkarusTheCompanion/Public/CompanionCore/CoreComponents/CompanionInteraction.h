@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "CompanionInterfaces/CompInteraction.h"
 #include "Components/ActorComponent.h"
+#include "WorldCollision.h"
 #include "CompanionInterfaces/CompInteraction.h"
 #include "CompanionInteraction.generated.h"
 
@@ -23,6 +24,7 @@ public:
 	UCompanionInteraction();
 	
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out) const override;
 
@@ -47,8 +49,17 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
 	bool bShowDebugTraces = false;
     
-	// Trace and find the best interactable actor
-	AActor* FindBestInteractable();
+	// Start the async sphere sweep for interactables around the owner
+	void RequestInteractionSweep();
+	
+	// Sweep results arrived: pick the best interactable from them
+	void OnInteractionSweepDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+	
+	// Find the closest interactable among the sweep hits
+	AActor* FindBestInteractable(const FVector& Location, const TArray<FHitResult>& HitResults) const;
+	
+	// Store the new interactable and broadcast if it changed
+	void SetCurrentInteractable(AActor* NewInteractable);
 
 	// Networked interaction methods
 	UFUNCTION(Server, Reliable, WithValidation)
@@ -67,5 +78,11 @@ private:
 	// Currently detected interactable actor
 	UPROPERTY(Transient)
 	TWeakObjectPtr<AActor> CurrentInteractable;
+	
+	// Async sweep in flight (invalid when none)
+	FTraceHandle PendingSweep;
+	
+	// Bound once and reused for every sweep
+	FTraceDelegate SweepDelegate;
 };
 
@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "UObject/ObjectKey.h"
+#include "CompanionCore/CoreEnums/CompanionEnums.h"
+#include "CompanionCore/CoreBlackboard/CompanionBlackboardSnapshot.h"
+#include "CompanionBlackboardDefaults.generated.h"
+
+class UBlackboardData;
+
+/**
+ * Starting blackboard values for a companion.
+ * Baked once per blackboard asset into a raw value block that is copied in on possess,
+ * instead of setting every key individually.
+ */
+UCLASS(BlueprintType, meta=(DisplayName="Companion Blackboard Defaults"))
+class IKARUSTHECOMPANION_API UCompanionBlackboardDefaults : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    /* ---------- Utility scores ---------- */
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Utility Scores", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float IdleScore = 0.2f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Utility Scores", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float FollowScore = 0.5f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Utility Scores", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float PatrolScore = 0.3f;
+
+    /** Higher priority for survival game */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Utility Scores", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float GatherScore = 0.8f;
+
+    /** Higher for combat in survival game */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Utility Scores", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float CombatScore = 0.9f;
+
+    /* ---------- Task state ---------- */
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Task State")
+    ECompanionTask InitialTask = ECompanionTask::None;
+
+    /* ---------- Survival ---------- */
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Survival", meta=(ClampMin="0"))
+    int32 InventorySpace = 10;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Survival", meta=(ClampMin="0"))
+    int32 ResourceAmount = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Survival", meta=(ClampMin="0.0"))
+    float CurrentStamina = 100.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Survival", meta=(ClampMin="0.0"))
+    float MaxStamina = 100.0f;
+
+    /** Raw default-value block for a blackboard asset, baked on first use */
+    const FCompanionBlackboardSnapshot& GetBakedValues(const UBlackboardData& BlackboardAsset) const;
+
+    virtual void PostInitProperties() override;
+    virtual void BeginDestroy() override;
+
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+    /** Build the value block for one blackboard asset */
+    void Bake(const UBlackboardData& BlackboardAsset, FCompanionBlackboardSnapshot& OutValues) const;
+
+    /** Drop the block baked for an asset whose keys changed; its key IDs and offsets no longer hold */
+    void HandleKeysUpdated(UBlackboardData* Asset);
+
+    /** Baked value blocks per blackboard asset */
+    mutable TMap<TObjectKey<UBlackboardData>, FCompanionBlackboardSnapshot> BakedValues;
+};
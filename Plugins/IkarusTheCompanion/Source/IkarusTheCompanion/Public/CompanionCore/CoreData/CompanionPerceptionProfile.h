@@ -0,0 +1,121 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "CompanionPerceptionProfile.generated.h"
+
+class UAISenseConfig_Sight;
+class UAISenseConfig_Hearing;
+
+/**
+ * Perception tuning shared by every companion that references it.
+ * Sense configs are created on demand per quantized radius/angle and shared by all controllers
+ * that resolve to the same values, so companions no longer own a sight and hearing config each.
+ * Shared configs must never be modified: pick a different one instead.
+ * They live in the transient package and are dropped when a game world is cleaned up.
+ */
+UCLASS(BlueprintType, meta=(DisplayName="Companion Perception Profile"))
+class IKARUSTHECOMPANION_API UCompanionPerceptionProfile : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    /* ---------- Sight ---------- */
+
+    /** Sight radius before LOD, task, time-of-day and crowd scaling */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta=(ClampMin="0.0"))
+    float SightRadius = 1000.f;
+
+    /** How much farther than the sight radius a seen target stays seen */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta=(ClampMin="0.0"))
+    float LoseSightRadiusOffset = 50.f;
+
+    /** Sight half-angle outside combat */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta=(ClampMin="0.0", ClampMax="180.0"))
+    float PeripheralVisionAngle = 90.f;
+
+    /** Sight half-angle while in combat */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta=(ClampMin="0.0", ClampMax="180.0"))
+    float CombatPeripheralVisionAngle = 120.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta=(ClampMin="0.0"))
+    float SightMaxAge = 5.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta=(ClampMin="0.0"))
+    float AutoSuccessRangeFromLastSeenLocation = 900.f;
+
+    /* ---------- Hearing ---------- */
+
+    /** Hearing range before LOD, task and crowd scaling */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hearing", meta=(ClampMin="0.0"))
+    float HearingRange = 1500.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hearing", meta=(ClampMin="0.0"))
+    float HearingMaxAge = 7.f;
+
+    /* ---------- Affiliation ---------- */
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Affiliation")
+    bool bDetectEnemies = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Affiliation")
+    bool bDetectFriendlies = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Affiliation")
+    bool bDetectNeutrals = true;
+
+    /* ---------- Adaptive scaling ---------- */
+
+    /** Seconds between handled non-threat stimulus batches at full fidelity; lower LODs, idling and crowds stretch it */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Adaptive", meta=(ClampMin="0.0"))
+    float SenseUpdateInterval = 0.1f;
+
+    /** Radius multiplier while idle or without a task */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Adaptive", meta=(ClampMin="0.0"))
+    float IdlePerceptionScale = 0.75f;
+
+    /** Radius multiplier while in combat */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Adaptive", meta=(ClampMin="0.0"))
+    float CombatPerceptionScale = 1.25f;
+
+    /** Neighbour count (from social awareness) at which the surroundings count as crowded */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Adaptive", meta=(ClampMin="1"))
+    int32 CrowdedNeighbourCount = 8;
+
+    /** Radius multiplier when crowded; plenty of stimuli are already close by */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Adaptive", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float CrowdedPerceptionScale = 0.75f;
+
+    /** Radii are snapped to this step before looking up a shared config; larger steps mean more sharing */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Adaptive", meta=(ClampMin="1.0"))
+    float RadiusQuantization = 50.f;
+
+    /** Shared sight config for a radius and half-angle (both quantized; read the actual values back from the config) */
+    UAISenseConfig_Sight* GetSightConfig(float Radius, float HalfAngleDegrees) const;
+
+    /** Shared hearing config for a range (quantized) */
+    UAISenseConfig_Hearing* GetHearingConfig(float Range) const;
+
+    virtual void PostInitProperties() override;
+    virtual void BeginDestroy() override;
+
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+    int32 QuantizeRadius(float Radius) const;
+
+    /** Drop the shared configs when a game world goes away */
+    void HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+    /** Shared sight configs by quantized radius (high 32 bits) and half-angle in degrees (low 32 bits) */
+    UPROPERTY(Transient)
+    mutable TMap<uint64, TObjectPtr<UAISenseConfig_Sight>> SightConfigs;
+
+    /** Shared hearing configs by quantized range */
+    UPROPERTY(Transient)
+    mutable TMap<int32, TObjectPtr<UAISenseConfig_Hearing>> HearingConfigs;
+};
@@ -114,6 +114,25 @@ enum class EInteractionResult : uint8
 	Exceptional UMETA(DisplayName = "Exceptional")
 };
 
+/** AI level-of-detail bucket, picked from distance and on-screen relevance to the nearest player */
+UENUM(BlueprintType)
+enum class ECompanionAILOD : uint8
+{
+	High UMETA(DisplayName = "High"),
+	Medium UMETA(DisplayName = "Medium"),
+	Low UMETA(DisplayName = "Low"),
+	Dormant UMETA(DisplayName = "Dormant")
+};
+
+/** What kind of pawn a neighbour is, for social awareness */
+UENUM(BlueprintType)
+enum class ECompanionNeighbourKind : uint8
+{
+	Player UMETA(DisplayName = "Player"),
+	Companion UMETA(DisplayName = "Companion"),
+	NPC UMETA(DisplayName = "NPC")
+};
+
 /** Positioning preference relative to a target (typically the player) */
 UENUM(BlueprintType)
 enum class EPositioningPreference : uint8
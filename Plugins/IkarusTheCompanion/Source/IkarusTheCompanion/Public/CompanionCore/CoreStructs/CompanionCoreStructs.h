@@ -7,6 +7,9 @@
 #include "Engine/DataTable.h"
 #include "CompanionCoreStructs.generated.h"
 
+class AActor;
+class APawn;
+
 /** Designer-editable bundle of movement speeds. */
 USTRUCT(BlueprintType)
 struct FCompanionMovementPreset : public FTableRowBase
@@ -32,6 +35,109 @@ struct FCompanionMovementPreset : public FTableRowBase
     float FlyingSpeed   = 500.f;
 };
 
+/**
+ * Per-bucket tuning for companion AI level of detail.
+ * Each bucket scales how often the companion's AI subsystems run.
+ */
+USTRUCT(BlueprintType)
+struct IKARUSTHECOMPANION_API FCompanionAILODSettings
+{
+    GENERATED_BODY()
+
+    /** Companions whose significance distance is at or below this use the bucket */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|LOD", meta=(ClampMin="0.0"))
+    float MaxDistance = 2500.f;
+
+    /** Seconds between batched blackboard refreshes */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|LOD", meta=(ClampMin="0.05"))
+    float BlackboardUpdateInterval = 0.1f;
+
+    /** Multiplier applied to behavior tree service intervals */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|LOD", meta=(ClampMin="1.0"))
+    float ServiceIntervalScale = 1.f;
+
+    /** Minimum seconds between ticks of latent behavior tree tasks (0 = every frame) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|LOD", meta=(ClampMin="0.0"))
+    float TaskTickInterval = 0.f;
+
+    /** Tick interval of the pawn's movement component (0 = every frame) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|LOD", meta=(ClampMin="0.0"))
+    float MovementTickInterval = 0.f;
+
+    /** Multiplier applied to sight and hearing radii */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|LOD", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float PerceptionRadiusScale = 1.f;
+
+    /** Whether perception senses stay enabled in this bucket */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|LOD")
+    bool bPerceptionEnabled = true;
+
+    /** Pause behavior tree logic entirely while in this bucket */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|LOD")
+    bool bPauseBehaviorTree = false;
+};
+
+/** Per-companion replacements for values of its shared perception profile */
+USTRUCT(BlueprintType)
+struct IKARUSTHECOMPANION_API FCompanionPerceptionOverrides
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, Category="AI|Perception", meta=(InlineEditConditionToggle))
+    bool bOverrideSightRadius = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Perception", meta=(EditCondition="bOverrideSightRadius", ClampMin="0.0"))
+    float SightRadius = 1000.f;
+
+    UPROPERTY(EditAnywhere, Category="AI|Perception", meta=(InlineEditConditionToggle))
+    bool bOverrideHearingRange = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Perception", meta=(EditCondition="bOverrideHearingRange", ClampMin="0.0"))
+    float HearingRange = 1500.f;
+
+    UPROPERTY(EditAnywhere, Category="AI|Perception", meta=(InlineEditConditionToggle))
+    bool bOverridePeripheralVisionAngle = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Perception", meta=(EditCondition="bOverridePeripheralVisionAngle", ClampMin="0.0", ClampMax="180.0"))
+    float PeripheralVisionAngle = 90.f;
+};
+
+/** Perception values currently applied to a companion, after LOD, task, time of day and crowding */
+USTRUCT(BlueprintType)
+struct IKARUSTHECOMPANION_API FCompanionPerceptionSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="AI|Perception")
+    float SightRadius = 0.f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="AI|Perception")
+    float LoseSightRadius = 0.f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="AI|Perception")
+    float PeripheralVisionAngleDegrees = 0.f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="AI|Perception")
+    float HearingRange = 0.f;
+
+    /** Seconds between batches of queued stimuli handled by the controller (0 = every frame) */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="AI|Perception")
+    float SenseUpdateInterval = 0.f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="AI|Perception")
+    bool bSensesEnabled = false;
+
+    /** Whether the senses differ enough from Other to be worth reconfiguring */
+    bool DiffersFrom(const FCompanionPerceptionSettings& Other) const
+    {
+        return bSensesEnabled != Other.bSensesEnabled
+            || FMath::Abs(SightRadius - Other.SightRadius) > 25.f
+            || FMath::Abs(HearingRange - Other.HearingRange) > 25.f
+            || FMath::Abs(PeripheralVisionAngleDegrees - Other.PeripheralVisionAngleDegrees) > 1.f
+            || !FMath::IsNearlyEqual(SenseUpdateInterval, Other.SenseUpdateInterval, 0.01f);
+    }
+};
+
 /**
  * A structure representing the core stats of a companion entity.
  * This structure is designed to track critical vitals such as health, stamina,
@@ -156,4 +262,88 @@ struct IKARUSTHECOMPANION_API FGatherResourceMemory
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Gather")
     float GatherRange = 200.0f;
     FGatherResourceMemory();
-};
\ No newline at end of file
+};
+
+/** One threat near a companion, as ranked by threat awareness (nearest first) */
+USTRUCT(BlueprintType)
+struct IKARUSTHECOMPANION_API FCompanionThreatInfo
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="AI|Threat")
+    TWeakObjectPtr<AActor> Actor;
+
+    UPROPERTY(BlueprintReadOnly, Category="AI|Threat")
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY(BlueprintReadOnly, Category="AI|Threat")
+    float Distance = 0.f;
+};
+
+/** How a companion's threat tracker weighs the threats it knows about */
+USTRUCT(BlueprintType)
+struct IKARUSTHECOMPANION_API FCompanionThreatScoring
+{
+    GENERATED_BODY()
+
+    /** Weight of proximity (1 at the companion, 0 at MaxDistance) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Threat", meta=(ClampMin="0.0"))
+    float DistanceWeight = 1.f;
+
+    /** Distance at which proximity stops counting */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Threat", meta=(ClampMin="1.0"))
+    float MaxDistance = 2000.f;
+
+    /** Weight of recent damage dealt to the companion */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Threat", meta=(ClampMin="0.0"))
+    float DamageWeight = 1.f;
+
+    /** Recent damage that earns the full damage weight */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Threat", meta=(ClampMin="0.0"))
+    float DamageForFullScore = 50.f;
+
+    /** Time constant of the exponential decay of remembered damage */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Threat", meta=(ClampMin="0.0"))
+    float DamageMemorySeconds = 5.f;
+
+    /** Bonus for a threat focused on the companion's owner */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Threat", meta=(ClampMin="0.0"))
+    float TargetingOwnerWeight = 1.f;
+
+    /** Bonus for a threat focused on the companion itself */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Threat", meta=(ClampMin="0.0"))
+    float TargetingSelfWeight = 0.75f;
+
+    /** A new threat must outscore the current target by this fraction to take over */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Threat", meta=(ClampMin="0.0"))
+    float SwitchMargin = 0.2f;
+
+    /** Threats not sensed for this long are dropped */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI|Threat", meta=(ClampMin="0.0"))
+    float ForgetAfterSeconds = 5.f;
+};
+
+/** Compact count of the pawns around a companion, as gathered by social awareness */
+USTRUCT(BlueprintType)
+struct IKARUSTHECOMPANION_API FCompanionNeighbourSummary
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="AI|Social")
+    int32 NumPlayers = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="AI|Social")
+    int32 NumCompanions = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="AI|Social")
+    int32 NumNPCs = 0;
+
+    /** Nearest neighbour of any kind (null when alone) */
+    UPROPERTY(BlueprintReadOnly, Category="AI|Social")
+    TWeakObjectPtr<APawn> Nearest;
+
+    UPROPERTY(BlueprintReadOnly, Category="AI|Social")
+    float NearestDistance = 0.f;
+
+    int32 Total() const { return NumPlayers + NumCompanions + NumNPCs; }
+};
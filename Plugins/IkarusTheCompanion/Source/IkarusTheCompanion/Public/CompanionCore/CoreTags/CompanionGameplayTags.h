@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NativeGameplayTags.h"
+
+/** Native gameplay tags used by the companion module */
+namespace CompanionTags
+{
+    /* ---------- Perception stimuli (set as FAIStimulus::Tag / noise event tag) ---------- */
+    IKARUSTHECOMPANION_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Stimulus);
+    IKARUSTHECOMPANION_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Stimulus_Threat);
+    IKARUSTHECOMPANION_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Stimulus_Resource);
+}
@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "CompanionVirtualState.generated.h"
+
+// This class does not need to be modified.
+UINTERFACE(BlueprintType)
+class UCompanionVirtualState : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Lets a companion pawn take part in virtualisation.
+ * SaveGame properties of the pawn and its components are carried across the round trip;
+ * these hooks move anything else into them before the pawn goes away and rebuild derived state after it respawns.
+ */
+class IKARUSTHECOMPANION_API ICompanionVirtualState
+{
+	GENERATED_BODY()
+
+public:
+	/** Called before the pawn is captured and destroyed */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Companion|Performance")
+	void OnCompanionVirtualised();
+
+	/** Called on the respawned pawn once its SaveGame properties are restored and it is possessed */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Companion|Performance")
+	void OnCompanionRehydrated();
+};